@@ -17,29 +17,77 @@
 
 #if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #endif
 
+#include "TaskManager/TaskCommand.h"
+#include "TaskManager/TaskExecutor.h"
+#include "TaskManager/TaskPool.h"
+#include "TaskManager/TaskPtr.h"
+#include "TaskManager/TaskStatic.h"
+#include "TaskManager/TaskTraits.h"
+
 namespace arduino {
 namespace task {
 
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+    // tasks are owned by the Manager or the parent task, Ref is a non-owning pointer
+    template <typename T>
+    using Ref = Ptr<T>;
+#else
     template <typename T>
     using Ref = std::shared_ptr<T>;
+#endif
     using Func = std::function<void(void)>;
 
 #if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#ifdef TASKMANAGER_POOL_SIZE
+    template <typename T>
+    using Vec = std::vector<T, PoolAllocator<T>>;
+#else
     template <typename T>
     using Vec = std::vector<T>;
+#endif
 #else
     template <typename T>
     using Vec = arx::stdx::vector<T>;
 #endif
 
+    // all tasks and subtasks are created here
+    template <typename TaskType, typename... Args>
+    Ref<TaskType> make_task(Args&&... args) {
+#if defined(TASKMANAGER_UNIQUE_OWNERSHIP)
+        return Ref<TaskType>(new TaskType(detail::forward<Args>(args)...));  // from Pool if TASKMANAGER_POOL_SIZE
+#elif defined(TASKMANAGER_POOL_SIZE)
+        return std::allocate_shared<TaskType>(PoolAllocator<TaskType>(), detail::forward<Args>(args)...);
+#else
+        return std::make_shared<TaskType>(detail::forward<Args>(args)...);
+#endif
+    }
+
+    namespace detail {
+        // downcast of Ref (e.g. Ref<Base> -> Ref<Speak>)
+        template <typename T, typename U>
+        inline Ref<T> ref_cast(const Ref<U>& r) {
+#if defined(TASKMANAGER_UNIQUE_OWNERSHIP)
+            return Ref<T>(static_cast<T*>(r.get()));
+#elif ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            return std::static_pointer_cast<T>(r);
+#else
+            return (Ref<T>)r;
+#endif
+        }
+    }  // namespace detail
+
 }  // namespace task
 }  // namespace arduino
 
 #include "TaskManager/TaskBase.h"
+#include "TaskManager/TaskBulk.h"
+#include "TaskManager/TaskCoroutine.h"
 #include "TaskManager/TaskEmpty.h"
+#include "TaskManager/TaskHandle.h"
 
 namespace arduino {
 namespace task {
@@ -47,12 +95,159 @@ namespace task {
     using TaskList = Vec<Ref<Base>>;
     using FuncWithTaskPtr = std::function<void(Base*)>;
 
-    class Manager {
+    enum class SchedulerMode : uint8_t { LINEAR, DEADLINE };
+
+    class Manager : public BulkControl<Manager> {
+        friend class Base;
+        friend class BulkControl<Manager>;
+        friend class Group;
+
         Manager() {}
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+        ~Manager() {
+            for (auto& t : tasks) delete t.get();
+            flush_retired();
+        }
+#endif
         Manager(const Manager&) = delete;
         Manager& operator=(const Manager&) = delete;
 
+        struct Deadline {
+            int64_t due_us;
+            uint16_t slot;
+            uint16_t generation;
+            uint32_t seq;
+        };
+
+        // slot storage: erased slot becomes nullptr and is reused by next add()
         TaskList tasks;
+        Vec<uint16_t> generations;
+        Vec<uint16_t> free_slots;
+        size_t num_tasks {0};
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        NameIndex<Ref<Base>> names;
+        size_t num_unindexed {0};  // tasks hidden by another task with the same name
+#endif
+
+        // for SchedulerMode::DEADLINE (allocated when used: a Manager in LINEAR mode has only the pointers)
+        SchedulerMode scheduler {SchedulerMode::LINEAR};
+        Lazy<Vec<Deadline>> deadlines;   // min-heap by due_us
+        Lazy<Vec<Deadline>> due_tasks;   // tasks popped from deadlines in the current update()
+        Lazy<Vec<uint16_t>> idle_tasks;  // tasks which override idle() (or whose subtasks do)
+        Base* processing {nullptr};
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        // for setPhaseStagger(): tasks whose intervals are multiples of the shortest one make a family
+        static constexpr uint32_t STAGGER_MAX_RATIO = 64;  // longer intervals make another family
+        static constexpr uint32_t STAGGER_MAX_SLOTS = 32;  // phases in the shortest interval of the family
+        struct StaggerTask {
+            Base* task;
+            double interval_us;
+            uint32_t cost;   // average time of update_recursive() [us] (1 without the profiler)
+            uint32_t ratio;  // interval / shortest interval of the family
+            bool b_new;      // started and not updated yet (its phase can be moved)
+        };
+        // atomic because reschedule() is called from worker threads of the executor (TASKMANAGER_EXECUTOR_ENABLE)
+        // stagger() itself runs on the thread of update() before the workers are dispatched
+        std::atomic<bool> b_stagger {false};
+        std::atomic<bool> b_stagger_pending {false};  // tasks may have been started since the last update()
+#endif
+
+        // for Group: bit i of Base::group_mask is groups[i] (allocated when the first group is created)
+        static constexpr size_t MAX_GROUPS = 16;
+        struct GroupEntry {
+            TaskName name;
+            Vec<uint16_t> slots;  // members in the order they were added
+        };
+        Lazy<Vec<GroupEntry>> groups;
+        Lazy<TaskList> retired;  // tasks and subtasks erased inside of update() (released after it because they may be running)
+        bool b_updating {false};
+
+        struct UpdateScope {
+            Manager& m;
+            const bool b_prev;
+            UpdateScope(Manager& m) : m(m), b_prev(m.b_updating) {
+                m.b_updating = true;
+            }
+            ~UpdateScope() {
+                m.b_updating = b_prev;
+                if (!b_prev && !m.retired.empty()) m.flush_retired();
+            }
+        };
+
+        // commands posted from interrupts or other threads
+        struct PostedCommand {
+            uint16_t slot;
+            uint16_t generation;
+            Command command;
+        };
+        CommandQueue<PostedCommand, TASKMANAGER_COMMAND_QUEUE_SIZE> commands;
+
+        // for updateWithBudget(): due tasks carried over to the next call
+        struct Pending {
+            uint16_t slot;
+            uint16_t generation;
+        };
+        Lazy<Vec<Pending>> pending;
+        // next due time of each slot in SchedulerMode::LINEAR (-1: not scheduled), which has no heap of them
+        Lazy<Vec<int64_t>> budget_due;
+
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+        // for setWorkers(): tasks of the current tick (kept alive while workers run them)
+        struct Job {
+            Ref<Base> task;
+            uint16_t slot;
+        };
+        std::unique_ptr<Executor> executor;
+        Vec<Job> jobs;
+        bool b_dispatching {false};  // workers are running
+        std::mutex resched_mtx;      // reschedule() from workers is deferred until the barrier
+        Vec<uint16_t> resched_slots;
+#endif
+        uint32_t tick {0};
+        uint32_t prev_us {0};
+        uint32_t us_overflow {0};
+
+    public:
+        // counters of updateWithBudget()
+        struct BudgetStats {
+            uint32_t calls {0};      // number of updateWithBudget() calls
+            uint32_t exhausted {0};  // calls which ran out of the budget before all due tasks run
+            uint32_t deferred {0};   // total number of tasks carried over to the next call
+            uint16_t max_wait {0};   // max number of calls a task has been deferred
+        };
+
+        // counters of setLoadShedding()
+        struct LoadStats {
+            uint32_t windows {0};     // number of windows in which the load was measured
+            uint32_t overloaded {0};  // windows whose load was higher than the high threshold
+            uint32_t degraded {0};    // steps which lowered the frame rate of tasks
+            uint32_t restored {0};    // steps which raised the frame rate of tasks back
+        };
+
+    private:
+        BudgetStats budget_stats;
+
+        // for setLoadShedding(): load is the time of update() calls in which tasks run / time of the window
+        static constexpr float LOAD_STEP = 0.75f;  // frame rate is multiplied (or divided) by this in a step
+        bool b_load_shedding {false};
+        float load_high {0.9f};
+        float load_low {0.7f};
+        float load {0.f};
+        uint32_t load_window_us {100000};
+        uint32_t load_window_begin_us {0};
+        uint32_t load_busy_us {0};
+        LoadStats load_stats;
+
+        struct LoadScope {
+            Manager& m;
+            const uint32_t begin_us;
+            const uint32_t calls;
+            LoadScope(Manager& m) : m(m), begin_us(m.b_load_shedding ? micros() : 0), calls(Base::update_calls()) {}
+            ~LoadScope() {
+                if (m.b_load_shedding) m.monitor_load(begin_us, calls != Base::update_calls());
+            }
+        };
 
     public:
         static Manager& get() {
@@ -60,78 +255,324 @@ namespace task {
             return m;
         }
 
-        Ref<TaskEmpty> add(const Func& task) {
-            return add("", task);
+        // task callback: void() or void(Base*)
+        // the callable is stored in the task without heap allocation (see TASKMANAGER_FUNCTION_CAPACITY)
+        template <typename F, typename detail::enable_if<detail::is_task_func<F>::value>::type* = nullptr>
+        Handle<TaskEmpty> add(F&& task) {
+            return add("", detail::forward<F>(task));
         }
 
-        Ref<TaskEmpty> add(const String& name, const Func& task) {
-            Ref<TaskEmpty> t = std::make_shared<TaskEmpty>(name);
-            t->onUpdate(task);
-            tasks.emplace_back(t);
-            tasks.shrink_to_fit();
-            t->begin_recursive();
-            return t;
+        template <typename F, typename detail::enable_if<detail::is_task_func<F>::value>::type* = nullptr>
+        Handle<TaskEmpty> add(const String& name, F&& task) {
+            Ref<TaskEmpty> t = make_task<TaskEmpty>(name);
+            t->add_update_func(detail::forward<F>(task));
+            return attach<TaskEmpty>(t);
         }
 
-        Ref<TaskEmpty> add(const FuncWithTaskPtr& task) {
-            return add("", task);
+        // task class: constructed by TaskType(name, args...)
+        template <typename TaskType>
+        Handle<TaskType> add() {
+            return add<TaskType>("");
         }
 
-        Ref<TaskEmpty> add(const String& name, const FuncWithTaskPtr& task) {
-            Ref<TaskEmpty> t = std::make_shared<TaskEmpty>(name);
-            t->add_update_func(task);
-            tasks.emplace_back(t);
-            tasks.shrink_to_fit();
-            t->begin_recursive();
-            return t;
+        template <typename TaskType, typename... Args>
+        Handle<TaskType> add(const String& name, Args&&... args) {
+            Ref<TaskType> t = make_task<TaskType>(name, detail::forward<Args>(args)...);
+            return attach<TaskType>(t);
         }
 
-        template <typename TaskType>
-        Ref<TaskType> add() {
-            return add<TaskType>("");
+#ifdef TASKMANAGER_HAS_COROUTINE
+        // run the coroutine as a task which is resumed by the scheduler (erased when it returns)
+        Handle<CoroutineTask> spawn(Coroutine&& c) {
+            return spawn("", detail::move(c));
         }
-
-        template <typename TaskType>
-        Ref<TaskType> add(const String& name) {
-            Ref<TaskType> t = std::make_shared<TaskType>(name);
-            tasks.emplace_back(t);
-            tasks.shrink_to_fit();
-            t->begin_recursive();
-            return t;
+        Handle<CoroutineTask> spawn(const String& name, Coroutine&& c) {
+            Ref<CoroutineTask> t = make_task<CoroutineTask>(name, detail::move(c));
+            t->setAutoErase(true);
+            t->wake();  // run until the first co_await in the next update()
+            Handle<CoroutineTask> h = attach<CoroutineTask>(t);
+            t->self = h;
+            return h;
         }
+#endif
 
         void update() {
-            auto it = tasks.begin();
-            while (it != tasks.end()) {
-                (*it)->update_recursive();
-                if ((*it)->isStopping() && (*it)->isAutoErase()) {
-                    it = tasks.erase(it);
-                } else {
-                    ++it;
+            UpdateScope scope(*this);
+            LoadScope load_scope(*this);
+            drain_commands();
+            if (!pending.empty()) flush_pending();
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            if (b_stagger_pending) stagger();
+#endif
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+            if (executor) {
+                update_parallel();
+                return;
+            }
+#endif
+            if (scheduler == SchedulerMode::DEADLINE) {
+                update_deadline();
+                return;
+            }
+            // tasks can be added/erased inside of update(): slots are never shifted
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                Base* t = tasks[i].get();
+                if (!t || t->isDormant() || t->isEventIdle()) continue;
+                const uint16_t generation = generations[i];
+                t->update_recursive();
+                // erased inside of update(): the slot may already be reused by a new task
+                if ((generations[i] != generation) || !tasks[i]) continue;
+                if (t->isStopping() && t->isAutoErase()) {
+                    release(i);
                 }
             }
         }
         void update(const String& name) {
+            UpdateScope scope(*this);
             auto task = getTaskByName(name);
-            if (task) {
-                task->update_recursive();
-                if (task->isStopping() && task->isAutoErase()) {
-                    erase(name);
-                }
-            }
+            if (task) update_slot(task->slot);
         }
         void update(const size_t idx) {
+            UpdateScope scope(*this);
             auto task = getTaskByIndex(idx);
-            if (task) {
-                task->update_recursive();
-                if (task->isStopping() && task->isAutoErase()) {
-                    erase(idx);
+            if (task) update_slot(idx);
+        }
+        template <typename TaskType>
+        void update(const Handle<TaskType>& h) {
+            UpdateScope scope(*this);
+            if (isValid(h)) update_slot(h.getSlot());
+        }
+
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+        // ========== Executor ==========
+
+        // run due top-level tasks on n worker threads in update() (0: run all tasks on the calling thread)
+        // tasks on workers should not control, add or erase other tasks: use setMainThread(true) for such tasks
+        void setWorkers(const size_t n) {
+            executor.reset();
+            if (n > 0) executor.reset(new Executor(n));
+        }
+        size_t getWorkers() const {
+            return executor ? executor->size() : 0;
+        }
+        const Executor* getExecutor() const {
+            return executor.get();
+        }
+#endif
+
+        // ========== Event-triggered task ==========
+
+        // wake the task started by startOnEvent() in the next update()
+        bool notify(const String& name) {
+            auto t = getTaskByName(name);
+            if (!t) return false;
+            t->notify();
+            return true;
+        }
+        template <typename TaskType>
+        bool notify(const Handle<TaskType>& h) {
+            Base* t = resolve(h.getSlot(), h.getGeneration());
+            if (!t) return false;
+            t->notify();
+            return true;
+        }
+
+        // ========== Command queue ==========
+
+        // control the task from interrupts or other threads (applied at the beginning of next update())
+        // returns false if the queue is full (see TASKMANAGER_COMMAND_QUEUE_SIZE)
+        template <typename TaskType>
+        bool post(const Handle<TaskType>& h, const Command& c) {
+            return commands.push(PostedCommand {h.getSlot(), h.getGeneration(), c});
+        }
+        // Command::call() which is not bound to a task
+        bool post(const Command& c) {
+            return commands.push(PostedCommand {0xFFFF, 0, c});
+        }
+        // number of commands dropped because the queue was full
+        uint32_t getCommandOverflows() const {
+            return commands.overflows();
+        }
+        void resetCommandOverflows() {
+            commands.resetOverflows();
+        }
+
+        // ========== Budgeted update ==========
+
+        // run due tasks in order of priority until budget_us is spent
+        // at least one task runs in every call, and the rest are carried over to the next call.
+        // deferred tasks get +1 priority for every call they wait so that they don't starve.
+        // returns the number of due tasks carried over to the next call (0: all due tasks have run)
+        size_t updateWithBudget(const uint32_t budget_us) {
+            const uint32_t begin_us = micros();
+            UpdateScope scope(*this);
+            LoadScope load_scope(*this);
+            drain_commands();
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            if (b_stagger_pending) stagger();
+#endif
+            const int64_t now = now_usec64();
+            ++tick;
+            ++budget_stats.calls;
+
+            collect_due(now);
+            sort_pending();
+
+            size_t i = 0;
+            for (; i < pending.size(); ++i) {
+                if ((i > 0) && ((uint32_t)(micros() - begin_us) >= budget_us)) break;
+                const Pending p = pending[i];
+                if ((generations[p.slot] != p.generation) || !tasks[p.slot]) continue;
+                tasks[p.slot]->b_budget_pending = false;
+                tasks[p.slot]->budget_wait = 0;
+                run_due(p.slot, now);
+            }
+
+            if (i < pending.size()) {
+                ++budget_stats.exhausted;
+                size_t n = 0;
+                for (; i < pending.size(); ++i) {
+                    const Pending p = pending[i];
+                    if ((generations[p.slot] != p.generation) || !tasks[p.slot]) continue;
+                    Base* t = tasks[p.slot].get();
+                    if (t->budget_wait < 0xFFFF) ++t->budget_wait;
+                    if (t->budget_wait > budget_stats.max_wait) budget_stats.max_wait = t->budget_wait;
+                    ++budget_stats.deferred;
+                    pending.get()[n++] = p;
                 }
+                pending.get().resize(n);
+                return n;
+            }
+            if (!pending.empty()) pending.get().clear();
+
+            // idle() of stopped tasks only if the budget remains
+            if ((scheduler == SchedulerMode::DEADLINE) && ((uint32_t)(micros() - begin_us) < budget_us)) {
+                for (size_t j = 0; j < idle_tasks.size(); ++j) {
+                    const uint16_t slot = idle_tasks[j];
+                    if ((tasks[slot]->sched_tick != tick) && !tasks[slot]->isRunning()) {
+                        if (process(slot, now)) --j;  // erased from idle_tasks
+                    }
+                }
+            }
+            return 0;
+        }
+
+        const BudgetStats& getBudgetStats() const {
+            return budget_stats;
+        }
+        void resetBudgetStats() {
+            budget_stats = BudgetStats();
+        }
+
+        // ========== Tickless idle ==========
+
+        // time [us] until any task (or subtask) should be updated next
+        // 0 means "now", -1 means "no task is scheduled" (idle() of stopped tasks is not counted)
+        int64_t nextDeadlineUsec() {
+            if (scheduler == SchedulerMode::DEADLINE) {
+                while (!deadlines.empty() && !isValid(deadlines[0])) pop_deadline();
+                if (deadlines.empty()) return -1;
+                const int64_t due = deadlines[0].due_us - now_usec64();
+                return (due > 0) ? due : 0;
+            }
+            int64_t due = -1;
+            for (auto& t : tasks) {
+                if (!t) continue;
+                due = Base::earlier(due, t->getNextDueUsec64());
+                if (due == 0) break;
+            }
+            return due;
+        }
+
+        // update() and then call sleep_fn(us) to wait until the next deadline
+        // sleep_fn: void(uint32_t us), which may return earlier by an external wake (e.g. interrupt)
+        template <typename SleepFunc>
+        void updateAndSleep(SleepFunc&& sleep_fn, const uint32_t max_sleep_us = 0xFFFFFFFF) {
+            update();
+            const int64_t due = nextDeadlineUsec();
+            if (due == 0) return;
+            const uint32_t us = ((due < 0) || (due > (int64_t)max_sleep_us)) ? max_sleep_us : (uint32_t)due;
+#ifdef TASKMANAGER_TRACE_ENABLE
+            const uint32_t begin_us = micros();
+            sleep_fn(us);
+            Trace::get().record(TraceEvent::SLEEP, 0, begin_us, micros() - begin_us);
+#else
+            sleep_fn(us);
+#endif
+        }
+
+        // ========== Load shedding ==========
+
+        // measure the load (time of update() calls in which tasks run / time) in every window_ms,
+        // lower the frame rate of adaptive tasks (Base::setAdaptiveFps()) of the lowest priority one step
+        // while the load is higher than high, and raise the highest priority ones back while it is lower than low
+        void setLoadShedding(const bool b, const float high = 0.9f, const float low = 0.7f,
+                             const uint32_t window_ms = 100) {
+            b_load_shedding = b;
+            load_high = high;
+            load_low = (low < high) ? low : high;
+            load_window_us = window_ms * 1000;
+            load_window_begin_us = micros();
+            load_busy_us = 0;
+            load = 0.f;
+            if (!b) {
+                // back to the preferred frame rate
+                for (auto& t : tasks)
+                    if (t && t->isDegraded()) t->changeFrameRate(t->preferred_fps);
+            }
+        }
+        bool isLoadShedding() const {
+            return b_load_shedding;
+        }
+        // load of the last window (0.0 - 1.0)
+        float getLoad() const {
+            return load;
+        }
+        const LoadStats& getLoadStats() const {
+            return load_stats;
+        }
+        void resetLoadStats() {
+            load_stats = LoadStats();
+        }
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        // ========== Phase staggering ==========
+
+        // spread the first frames of tasks which are started with the same or harmonic intervals
+        // (e.g. by Tasks.startFps(30)) across the interval so that they don't run in the same update()
+        // tasks which are already running keep their phases (enable this before starting tasks)
+        void setPhaseStagger(const bool b) {
+            b_stagger = b;
+        }
+        bool isPhaseStagger() const {
+            return b_stagger;
+        }
+#endif
+
+        // ========== Simulation ==========
+
+        // run tasks in virtual time until the clock (micros() extended to 64 bit) reaches until_us
+        // instead of sleeping, advance_fn(uint32_t us) moves the clock behind micros() to the next deadline
+        // (e.g. arduino_shim::advanceUsec() of extras/host), so hours of schedule run in a moment.
+        // tasks which are due in every update() are updated every min_step_us of virtual time
+        template <typename AdvanceFunc>
+        void simulate(const int64_t until_us, AdvanceFunc&& advance_fn, const uint32_t min_step_us = 1000) {
+            while (true) {
+                update();
+                const int64_t now = now_usec64();
+                if (now >= until_us) return;
+                int64_t step = nextDeadlineUsec();
+                if (step < 0) step = until_us - now;  // nothing is scheduled
+                if (step == 0) step = min_step_us ? min_step_us : 1;
+                if (step > until_us - now) step = until_us - now;
+                if (step > 0x7FFFFFFF) step = 0x7FFFFFFF;  // micros() must not wrap around twice in one step
+                advance_fn((uint32_t)step);
             }
         }
 
         void reset() {
-            for (auto& t : tasks) t->reset_recursive();
+            for (auto& t : tasks)
+                if (t) t->reset_recursive();
         }
         bool reset(const String& name) {
             auto t = getTaskByName(name);
@@ -151,390 +592,1077 @@ namespace task {
         }
 
         bool erase(const String& name) {
+            const uint16_t slot = find_slot(name);
+            if (slot == 0xFFFF) return false;
 #if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-            auto results =
-                std::remove_if(tasks.begin(), tasks.end(), [&](const Ref<Base>& t) { return (t->getName() == name); });
-            auto it = tasks.erase(results, tasks.end());
-            return it != tasks.end();
-#else
-            auto it = tasks.begin();
-            while (it != tasks.end()) {
-                if ((*it)->getName() == name) {
-                    it = tasks.erase(it);
-                    return true;
-                } else
-                    ++it;
+            if (num_unindexed > 0) {
+                // tasks hidden by another task with the same name are not indexed: erase all of them
+                const auto& key = make_name(name);
+                for (size_t i = 0; i < tasks.size(); ++i)
+                    if (tasks[i] && (tasks[i]->getName() == key)) release(i);
+                return true;
             }
-            return false;
 #endif
+            release(slot);
+            return true;
         }
         bool erase(const size_t idx) {
-            if (idx >= tasks.size()) return false;
-            auto it = tasks.begin() + idx;
-            tasks.erase(it);
+            if ((idx >= tasks.size()) || !tasks[idx]) return false;
+            release(idx);
+            return true;
+        }
+        template <typename TaskType>
+        bool erase(const Handle<TaskType>& h) {
+            if (!isValid(h)) return false;
+            release(h.getSlot());
             return true;
         }
 
         void clear() {
+            for (size_t i = 0; i < tasks.size(); ++i)
+                if (tasks[i]) release(i);
+            // empty slots are not iterated anymore (generations are kept to invalidate old handles)
             tasks.clear();
+            free_slots.clear();
+            deadlines.reset();
+            due_tasks.reset();
+            pending.reset();
+            budget_due.reset();
+        }
+
+        // preallocate containers for n tasks (avoid reallocation on every add())
+        void reserve(const size_t n) {
+            tasks.reserve(n);
+            generations.reserve(n);
+            free_slots.reserve(n);
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            names.reserve(n);
+#endif
+            if (scheduler == SchedulerMode::DEADLINE) reserve_deadline(n);
         }
 
         bool empty() const {
-            return tasks.size() == 0;
+            return num_tasks == 0;
         }
 
         size_t size() const {
-            return tasks.size();
+            return num_tasks;
         }
 
         bool exists(const String& name) const {
-            for (auto& t : tasks)
-                if (t->getName() == name) return true;
-            return false;
+            return find_slot(name) != 0xFFFF;
         }
 
         size_t getActiveTaskSize() const {
             size_t i = 0;
             for (const auto& t : tasks) {
-                if (t->isRunning()) ++i;
+                if (t && t->isRunning()) ++i;
             }
             return i;
         }
 
-        void setAutoErase(const bool b) {
-            for (auto& t : tasks) {
-                t->setAutoErase(b);
+        // ========== Group ==========
+
+        // group of tasks which are controlled together (created by the first call, up to 16 groups)
+        // Tasks.group("leds").startFps(30) touches only the members of "leds"
+        Group group(const String& name);
+
+        // ========== Scheduler ==========
+
+        // SchedulerMode::LINEAR (default) checks all tasks in every update()
+        // SchedulerMode::DEADLINE keeps running tasks in a min-heap ordered by their next due time
+        // and only updates the tasks which are due (and the stopped tasks which override idle())
+        void setSchedulerMode(const SchedulerMode m) {
+            if (scheduler == m) return;
+            scheduler = m;
+            deadlines.reset();
+            due_tasks.reset();
+            if (scheduler == SchedulerMode::DEADLINE) {
+                reserve_deadline(tasks.capacity());
+                const int64_t now = now_usec64();
+                for (size_t i = 0; i < tasks.size(); ++i)
+                    if (tasks[i]) push_deadline(now, i);
             }
         }
+        SchedulerMode getSchedulerMode() const {
+            return scheduler;
+        }
+
+#ifdef TASKMANAGER_PROFILER_ENABLE
+        // ========== Profiler ==========
+
+        // view of the profiles of all tasks: Tasks.stats().print(Serial);
+        class Stats {
+            const Manager& m;
+
+        public:
+            explicit Stats(const Manager& m) : m(m) {}
+
+            const Profile* get(const String& name) const {
+                auto t = m.getTaskByName(name);
+                return t ? &t->getProfile() : nullptr;
+            }
+            template <typename TaskType>
+            const Profile* get(const Handle<TaskType>& h) const {
+                Base* t = m.resolve(h.getSlot(), h.getGeneration());
+                return t ? &t->getProfile() : nullptr;
+            }
+            const Profile* operator[](const String& name) const {
+                return get(name);
+            }
+
+            // all tasks and their subtasks
+            void print(Print& p) const {
+                for (const auto& t : m.tasks)
+                    if (t) print(p, *t, 0);
+            }
+
+            void reset() {
+                for (const auto& t : m.tasks)
+                    if (t) t->resetProfile();
+            }
+
+        private:
+            static void print(Print& p, const Base& t, const size_t depth) {
+                for (size_t i = 0; i < depth; ++i) p.print("  ");
+                p.print(t.getName());
+                p.print(": ");
+                t.getProfile().print(p);
+                for (const auto& st : t.getSubTasks()) print(p, *st, depth + 1);
+            }
+        };
+
+        Stats stats() const {
+            return Stats(*this);
+        }
+#endif
+
+#ifdef TASKMANAGER_TRACE_ENABLE
+        // ========== Trace ==========
+
+        // enter() / update() / exit() / idle() of all tasks and sleeps of updateAndSleep() are recorded
+        // to a ring buffer of the latest TASKMANAGER_TRACE_SIZE events (enabled by default)
+        void setTracing(const bool b) {
+            Trace::get().enable(b);
+        }
+        bool isTracing() const {
+            return Trace::get().isEnabled();
+        }
+        void clearTrace() {
+            Trace::get().clear();
+        }
+
+        // stream the names of tasks and the events in the buffer (oldest first) as binary (see Trace)
+        // call this outside of update(): recording is paused while dumping
+        size_t dumpTrace(Print& p) const {
+            Trace& trace = Trace::get();
+            const bool b_enabled = trace.isEnabled();
+            trace.enable(false);
+
+            uint32_t names = 0;
+            for (const auto& t : tasks)
+                if (t) names += count_trace_names(*t);
+            const size_t events = trace.size();
+            size_t n = Trace::writeHeader(p, names, events, trace.lost());
+            for (const auto& t : tasks)
+                if (t) n += write_trace_names(p, *t);
+            n += trace.writeEvents(p, events);
+
+            trace.enable(b_enabled);
+            return n;
+        }
+#endif
+
+        // ========== Task access ==========
 
         template <typename TaskType = Base>
         Ref<TaskType> getTaskByName(const String& name) const {
-            for (auto& t : tasks)
-                if (t->getName() == name)
-#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-                    return std::static_pointer_cast<TaskType>(t);
-#else
-                    return (Ref<TaskType>)t;
-#endif
+            const uint16_t slot = find_slot(name);
+            if (slot != 0xFFFF) return detail::ref_cast<TaskType>(tasks[slot]);
             LOG_ERROR("No task found named", name);
             return nullptr;
         }
 
+        // index is the slot of the task: it is not changed by erasing other tasks
         template <typename TaskType = Base>
         Ref<TaskType> getTaskByIndex(const size_t i) const {
-            if (i >= tasks.size()) {
-                LOG_ERROR("Task index is out of bound:", i, "should be <", tasks.size());
+            if ((i >= tasks.size()) || !tasks[i]) {
+                LOG_ERROR("No task found at index:", i);
                 return nullptr;
             }
 
-#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-            return std::static_pointer_cast<TaskType>(tasks[i]);
-#else
-            return (Ref<TaskType>)tasks[i];
-#endif
+            return detail::ref_cast<TaskType>(tasks[i]);
         }
 
         template <typename TaskType = Base>
-        Ref<TaskType> operator[](const String& name) const {
-            return getTaskByName(name);
+        Ref<TaskType> getTaskByHandle(const Handle<TaskType>& h) const {
+            if (!isValid(h)) {
+                LOG_ERROR("Task handle is stale: slot", h.getSlot(), "generation", h.getGeneration());
+                return nullptr;
+            }
+            return detail::ref_cast<TaskType>(tasks[h.getSlot()]);
         }
 
         template <typename TaskType = Base>
-        Ref<TaskType> operator[](const size_t i) const {
-            return getTaskByIndex(i);
+        Handle<TaskType> getHandle(const String& name) const {
+            auto t = getTaskByName(name);
+            if (!t) return Handle<TaskType>();
+            return Handle<TaskType>(t->slot, generations[t->slot]);
         }
 
-        // ========== Task method wrappers ==========
-
-        void start() {
-            for (auto& t : tasks) t->start();
+        template <typename TaskType>
+        bool isValid(const Handle<TaskType>& h) const {
+            return resolve(h.getSlot(), h.getGeneration()) != nullptr;
         }
 
-        void startFromSec(const double from_sec) {
-            for (auto& t : tasks) t->startFromSec(from_sec);
-        }
-        void startFromMsec(const double from_ms) {
-            for (auto& t : tasks) t->startFromMsec(from_ms);
-        }
-        void startFromUsec(const double from_us) {
-            for (auto& t : tasks) t->startFromUsec(from_us);
+        Base* resolve(const uint16_t slot, const uint16_t generation) const {
+            if ((slot >= tasks.size()) || (generations[slot] != generation)) return nullptr;
+            return tasks[slot].get();
         }
 
-        void startForSec(const double for_sec, const bool loop = false) {
-            for (auto& t : tasks) t->startForSec(for_sec, loop);
-        }
-        void startForMsec(const double for_ms, const bool loop = false) {
-            for (auto& t : tasks) t->startForMsec(for_ms, loop);
-        }
-        void startForUsec(const double for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startForUsec(for_us, loop);
+        template <typename TaskType = Base>
+        Ref<TaskType> operator[](const String& name) const {
+            return getTaskByName(name);
         }
 
-        void startFromForSec(const double from_sec, const double for_sec, const bool loop = false) {
-            for (auto& t : tasks) t->startFromForSec(from_sec, for_sec, loop);
-        }
-        void startFromForMsec(const double from_ms, const double for_ms, const bool loop = false) {
-            for (auto& t : tasks) t->startFromForMsec(from_ms, for_ms, loop);
-        }
-        void startFromForUsec(const double from_us, const double for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startFromForUsec(from_us, for_us, loop);
-        }
-        void startFromForUsec64(const int64_t from_us, const int64_t for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startFromForUsec64(from_us, for_us, loop);
+        template <typename TaskType = Base>
+        Ref<TaskType> operator[](const size_t i) const {
+            return getTaskByIndex(i);
         }
 
-        void startFromCount(const double from_count) {
-            for (auto& t : tasks) t->startFromCount(from_count);
-        }
-        void startForCount(const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startForCount(for_count, loop);
-        }
-        void startFromForCount(const double from_count, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startFromForCount(from_count, for_count, loop);
+    private:
+        // slot of the first task added with the name (0xFFFF if not found)
+        uint16_t find_slot(const String& name) const {
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            auto it = names.find(make_name(name));
+            return (it != names.end()) ? it->second->slot : 0xFFFF;
+#else
+            // no index without libstdc++: tasks are few enough to be scanned
+            const auto& key = make_name(name);
+            for (size_t i = 0; i < tasks.size(); ++i)
+                if (tasks[i] && (tasks[i]->getName() == key)) return (uint16_t)i;
+            return 0xFFFF;
+#endif
         }
 
-        void startIntervalSec(const double interval_sec) {
-            for (auto& t : tasks) t->startIntervalSec(interval_sec);
-        }
-        void startIntervalMsec(const double interval_ms) {
-            for (auto& t : tasks) t->startIntervalMsec(interval_ms);
-        }
-        void startIntervalUsec(const double interval_us) {
-            for (auto& t : tasks) t->startIntervalUsec(interval_us);
-        }
+        template <typename TaskType>
+        Handle<TaskType> attach(const Ref<TaskType>& t) {
+            uint16_t slot = 0;
+            if (free_slots.empty()) {
+                if (tasks.size() >= 0xFFFF) {  // 0xFFFF is reserved for invalid handle
+                    LOG_ERROR("Couldn't add task: number of tasks exceeds", 0xFFFF);
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+                    delete t.get();
+#endif
+                    return Handle<TaskType>();
+                }
+                slot = (uint16_t)tasks.size();
+                tasks.emplace_back(t);
+                if (generations.size() <= slot) generations.emplace_back(0);
+            } else {
+                slot = free_slots.back();
+                free_slots.pop_back();
+                tasks[slot] = t;
+            }
+            ++num_tasks;
+            t->slot = slot;
+            t->begin_recursive();
 
-        void startIntervalFromSec(const double interval_sec, const double from_sec) {
-            for (auto& t : tasks) t->startIntervalFromSec(interval_sec, from_sec);
-        }
-        void startIntervalFromMsec(const double interval_ms, const double from_ms) {
-            for (auto& t : tasks) t->startIntervalFromMsec(interval_ms, from_ms);
-        }
-        void startIntervalFromUsec(const double interval_us, const double from_us) {
-            for (auto& t : tasks) t->startIntervalFromUsec(interval_us, from_us);
-        }
-        void startIntervalSecFromCount(const double interval_sec, const double from_count) {
-            for (auto& t : tasks) t->startIntervalSecFromCount(interval_sec, from_count);
-        }
-        void startIntervalMsecFromCount(const double interval_ms, const double from_count) {
-            for (auto& t : tasks) t->startIntervalMsecFromCount(interval_ms, from_count);
-        }
-        void startIntervalUsecFromCount(const double interval_us, const double from_count) {
-            for (auto& t : tasks) t->startIntervalUsecFromCount(interval_us, from_count);
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            // keeps the first one if the name is duplicated
+            if (!names.emplace(t->getName(), t).second) ++num_unindexed;
+#endif
+            t->manager = this;
+            t->template detect_hooks<TaskType>();
+            if (t->hasIdleHook()) listen_idle(t.get());
+            if (scheduler == SchedulerMode::DEADLINE)
+                push_deadline(now_usec64(), slot);
+            else
+                mark_budget_due(slot);
+            return Handle<TaskType>(slot, generations[slot]);
+        }
+
+        // erase the task in the slot and invalidate its handles
+        void release(const size_t slot) {
+            Ref<Base> t = tasks[slot];
+            t->manager = nullptr;
+#ifdef TASKMANAGER_HAS_COROUTINE
+            if (!t->stop_waiters.empty()) t->notify_stop_waiters();
+#endif
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            auto idx = names.find(t->getName());
+            if ((idx != names.end()) && (idx->second == t)) {
+                names.erase(idx);
+                // index the next task which has same name (if exists)
+                if (num_unindexed > 0) {
+                    for (auto& other : tasks) {
+                        if (other && (other->manager == this) && (other->getName() == t->getName())) {
+                            names.emplace(other->getName(), other);
+                            --num_unindexed;
+                            break;
+                        }
+                    }
+                }
+            } else {
+                --num_unindexed;
+            }
+#endif
+            if (t->b_idle_listed) {
+                t->b_idle_listed = false;
+                Vec<uint16_t>& idles = idle_tasks.get();
+                for (auto it = idles.begin(); it != idles.end(); ++it) {
+                    if (*it == slot) {
+                        idles.erase(it);
+                        break;
+                    }
+                }
+            }
+            for (size_t i = 0; t->group_mask; ++i) {
+                if (t->group_mask & (1 << i)) leave_group(t.get(), i);
+            }
+            tasks[slot] = nullptr;
+            retire(t);
+            ++generations[slot];  // entries in deadlines and due_tasks become stale
+            free_slots.emplace_back((uint16_t)slot);
+            --num_tasks;
         }
 
-        void startIntervalForSec(const double interval_sec, const double for_sec, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalForSec(interval_sec, for_sec, loop);
-        }
-        void startIntervalForMsec(const double interval_ms, const double for_ms, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalForMsec(interval_ms, for_ms, loop);
-        }
-        void startIntervalForUsec(const double interval_us, const double for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalForUsec(interval_us, for_us, loop);
-        }
-        void startIntervalSecForCount(const double interval_sec, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalSecForCount(interval_sec, for_count, loop);
-        }
-        void startIntervalMsecForCount(const double interval_ms, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalMsecForCount(interval_ms, for_count, loop);
-        }
-        void startIntervalUsecForCount(const double interval_us, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalUsecForCount(interval_us, for_count, loop);
+        template <typename F>
+        void for_each_task(F& f) {
+            for (auto& t : tasks)
+                if (t) f(*t);
         }
 
-        void startIntervalFromForSec(
-            const double interval_sec, const double from_sec, const double for_sec, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalFromForSec(interval_sec, from_sec, for_sec, loop);
-        }
-        void startIntervalFromForMsec(
-            const double interval_ms, const double from_ms, const double for_ms, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalFromForMsec(interval_ms, from_ms, for_ms, loop);
-        }
-        void startIntervalFromForUsec(
-            const double interval_us, const double from_us, const double for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalFromForUsec(interval_us, from_us, for_us, loop);
+        void leave_group(Base* t, const size_t id) {
+            t->group_mask &= ~(uint16_t)(1 << id);
+            Vec<uint16_t>& slots = groups.get()[id].slots;
+            for (auto it = slots.begin(); it != slots.end(); ++it) {
+                if (*it == t->slot) {
+                    slots.erase(it);
+                    break;
+                }
+            }
         }
-        void startIntervalSecFromForCount(
-            const double interval_sec, const double from_count, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalSecFromForCount(interval_sec, from_count, for_count, loop);
+
+        // a task erased inside of update() may be the running one: it is released after update() returns
+        void retire(const Ref<Base>& t) {
+            if (b_updating) {
+                retired.get().emplace_back(t);
+            } else {
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+                delete t.get();
+#endif
+            }
         }
-        void startIntervalMsecFromForCount(
-            const double interval_ms, const double from_count, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalMsecFromForCount(interval_ms, from_count, for_count, loop);
+        void flush_retired() {
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+            for (auto& t : retired) delete t.get();
+#endif
+            retired.reset();
+        }
+
+        void update_slot(const size_t slot) {
+            // the task may be erased (and the slot may be reused) inside of update()
+            const Ref<Base> t = tasks[slot];
+            const uint16_t generation = generations[slot];
+            t->update_recursive();
+            if ((generations[slot] != generation) || !tasks[slot]) return;
+            if (t->isStopping() && t->isAutoErase()) {
+                release(slot);
+            } else if (scheduler == SchedulerMode::DEADLINE) {
+                schedule(slot, now_usec64());
+            }
         }
-        void startIntervalUsecFromForCount(
-            const double interval_us, const double from_count, const double for_count, const bool loop = false) {
-            for (auto& t : tasks) t->startIntervalUsecFromForCount(interval_us, from_count, for_count, loop);
+
+        bool isValid(const Deadline& d) const {
+            return (generations[d.slot] == d.generation) && tasks[d.slot] && (tasks[d.slot]->sched_seq == d.seq);
         }
 
-        void startFromFrame(const double from_frame) {
-            for (auto& t : tasks) t->startFromFrame(from_frame);
+        void update_deadline() {
+            const int64_t now = now_usec64();
+            ++tick;
+
+            // pop all due tasks first so that tasks due every update() run only once
+            if (!due_tasks.empty()) due_tasks.get().clear();
+            while (!deadlines.empty() && (deadlines[0].due_us <= now)) {
+                const Deadline d = pop_deadline();
+                if (isValid(d)) due_tasks.get().emplace_back(d);
+            }
+
+            for (size_t i = 0; i < due_tasks.size(); ++i) {
+                const Deadline& d = due_tasks[i];
+                // the task may be erased by other tasks in this loop
+                if ((generations[d.slot] == d.generation) && tasks[d.slot]) process(d.slot, now);
+            }
+            for (size_t i = 0; i < idle_tasks.size(); ++i) {
+                const uint16_t slot = idle_tasks[i];
+                if ((tasks[slot]->sched_tick != tick) && !tasks[slot]->isRunning()) {
+                    if (process(slot, now)) --i;  // erased from idle_tasks
+                }
+            }
         }
 
-        void startForFrame(const double for_frame, const bool loop = false) {
-            for (auto& t : tasks) t->startForFrame(for_frame, loop);
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+        // due tasks run on workers and the barrier waits for all of them,
+        // then main thread tasks, auto-erase and scheduling are done on the calling thread
+        void update_parallel() {
+            const int64_t now = now_usec64();
+            ++tick;
+
+            jobs.clear();
+            if (scheduler == SchedulerMode::DEADLINE) {
+                while (!deadlines.empty() && (deadlines[0].due_us <= now)) {
+                    const Deadline d = pop_deadline();
+                    if (isValid(d) && (tasks[d.slot]->sched_tick != tick)) {
+                        tasks[d.slot]->sched_tick = tick;
+                        jobs.emplace_back(Job {tasks[d.slot], d.slot});
+                    }
+                }
+                for (size_t i = 0; i < idle_tasks.size(); ++i) {
+                    const uint16_t slot = idle_tasks[i];
+                    if ((tasks[slot]->sched_tick != tick) && !tasks[slot]->isRunning()) {
+                        tasks[slot]->sched_tick = tick;
+                        jobs.emplace_back(Job {tasks[slot], slot});
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < tasks.size(); ++i)
+                    if (tasks[i] && !tasks[i]->isDormant() && !tasks[i]->isEventIdle())
+                        jobs.emplace_back(Job {tasks[i], (uint16_t)i});
+            }
+
+            // jobs for workers first, then jobs for the main thread
+            size_t n = 0;
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                if (jobs[i].task->isMainThread()) continue;
+                if (n != i) {
+                    const Job j = jobs[n];
+                    jobs[n] = jobs[i];
+                    jobs[i] = j;
+                }
+                ++n;
+            }
+
+            b_dispatching = true;
+            executor->run(
+                n, [this](const size_t i) { jobs[i].task->update_recursive(); },
+                [this](const size_t i) { return (int)jobs[i].task->getAffinity(); });
+            b_dispatching = false;
+
+            for (size_t i = n; i < jobs.size(); ++i) {
+                const Job& j = jobs[i];
+                if (tasks[j.slot] != j.task) continue;  // erased by other tasks
+                processing = j.task.get();
+                j.task->update_recursive();
+                processing = nullptr;
+            }
+
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                const Job& j = jobs[i];
+                if (tasks[j.slot] != j.task) continue;  // erased inside of update()
+                if (j.task->isStopping() && j.task->isAutoErase()) {
+                    release(j.slot);
+                } else if (scheduler == SchedulerMode::DEADLINE) {
+                    schedule(j.slot, now);
+                }
+            }
+
+            for (size_t i = 0; i < resched_slots.size(); ++i) {
+                const uint16_t slot = resched_slots[i];
+                if (tasks[slot] && (tasks[slot]->sched_tick != tick)) push_deadline(now_usec64(), slot);
+            }
+            resched_slots.clear();
+            jobs.clear();
         }
+#endif
 
-        void startFromForFrame(const double from_frame, const double for_frame, const bool loop = false) {
-            for (auto& t : tasks) t->startFromForFrame(from_frame, for_frame, loop);
+        void drain_commands() {
+            PostedCommand pc;
+            while (commands.pop(pc)) apply(pc);
         }
 
-        void startFps(const double fps) {
-            for (auto& t : tasks) t->startFps(fps);
+        void apply(const PostedCommand& pc) {
+            const Command& c = pc.command;
+            if (c.type == Command::Type::CALL) {
+                if (c.callback.fn) c.callback.fn(c.callback.arg);
+                return;
+            }
+            Base* t = resolve(pc.slot, pc.generation);
+            if (!t) {
+                LOG_WARN("Command is ignored: task handle is stale: slot", pc.slot, "generation", pc.generation);
+                return;
+            }
+            switch (c.type) {
+                case Command::Type::START: t->start(); break;
+                case Command::Type::STOP: t->stop(); break;
+                case Command::Type::PLAY: t->play(); break;
+                case Command::Type::PAUSE: t->pause(); break;
+                case Command::Type::RESTART: t->restart(); break;
+                case Command::Type::START_FPS: t->startFps(c.value); break;
+                case Command::Type::START_INTERVAL_USEC: t->startIntervalUsec(c.value); break;
+                case Command::Type::RESET: t->reset_recursive(); break;
+                case Command::Type::NOTIFY: t->notify(); break;
+                case Command::Type::ERASE: release(pc.slot); break;
+                default: break;
+            }
         }
 
-        void startFpsFromSec(const double fps, const double from_sec) {
-            for (auto& t : tasks) t->startFpsFromSec(fps, from_sec);
+        // append newly due tasks to pending
+        void collect_due(const int64_t now) {
+            if (scheduler == SchedulerMode::DEADLINE) {
+                while (!deadlines.empty() && (deadlines[0].due_us <= now)) {
+                    const Deadline d = pop_deadline();
+                    if (isValid(d)) add_pending(d.slot);
+                }
+            } else {
+                Vec<int64_t>& due = budget_due.get();
+                while (due.size() < tasks.size()) due.emplace_back(0);  // new slots are due now
+                for (size_t i = 0; i < tasks.size(); ++i) {
+                    Base* t = tasks[i].get();
+                    if (!t || t->b_budget_pending) continue;
+                    // stopped tasks are updated every time to call idle() or to be erased
+                    const bool b_stopped = !t->isRunning() && (t->hasIdleHook() || t->isAutoErase());
+                    if (b_stopped || ((due[i] >= 0) && (due[i] <= now))) add_pending(i);
+                }
+            }
         }
-        void startFpsFromMsec(const double fps, const double from_ms) {
-            for (auto& t : tasks) t->startFpsFromMsec(fps, from_ms);
+
+        // the task is controlled (or added): due in the next updateWithBudget() of SchedulerMode::LINEAR
+        void mark_budget_due(const size_t slot) {
+            if (slot < budget_due.size()) budget_due.get()[slot] = 0;
         }
-        void startFpsFromUsec(const double fps, const double from_us) {
-            for (auto& t : tasks) t->startFpsFromUsec(fps, from_us);
+
+        void add_pending(const size_t slot) {
+            Base* t = tasks[slot].get();
+            if (t->b_budget_pending) return;
+            t->b_budget_pending = true;
+            pending.get().emplace_back(Pending {(uint16_t)slot, generations[slot]});
         }
-        void startFpsFromFrame(const double fps, const double from_frame) {
-            for (auto& t : tasks) t->startFpsFromFrame(fps, from_frame);
+
+        static uint32_t effective_priority(const Base* t) {
+            return (uint32_t)t->priority + t->budget_wait;
         }
 
-        void startFpsForSec(const double fps, const double for_sec, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsForSec(fps, for_sec, loop);
+        // stable insertion sort by effective priority (descending)
+        void sort_pending() {
+            if (pending.size() < 2) return;
+            Vec<Pending>& ps = pending.get();
+            for (size_t i = 1; i < ps.size(); ++i) {
+                const Pending p = ps[i];
+                const Base* t = tasks[p.slot].get();
+                if (!t || (generations[p.slot] != p.generation)) continue;  // skipped later
+                const uint32_t key = effective_priority(t);
+                size_t j = i;
+                while (j > 0) {
+                    const Pending& q = ps[j - 1];
+                    const Base* u = tasks[q.slot].get();
+                    const bool valid = u && (generations[q.slot] == q.generation);
+                    if (valid && (effective_priority(u) >= key)) break;
+                    ps[j] = ps[j - 1];
+                    --j;
+                }
+                ps[j] = p;
+            }
         }
-        void startFpsForMsec(const double fps, const double for_ms, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsForMsec(fps, for_ms, loop);
+
+        // hand carried-over tasks back to the regular update()
+        void flush_pending() {
+            const int64_t now = now_usec64();
+            for (size_t i = 0; i < pending.size(); ++i) {
+                const Pending& p = pending[i];
+                if ((generations[p.slot] != p.generation) || !tasks[p.slot]) continue;
+                tasks[p.slot]->b_budget_pending = false;
+                tasks[p.slot]->budget_wait = 0;
+                if (scheduler == SchedulerMode::DEADLINE) push_deadline(now, p.slot);
+            }
+            pending.get().clear();
         }
-        void startFpsForUsec(const double fps, const double for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsForUsec(fps, for_us, loop);
+
+        void run_due(const uint16_t slot, const int64_t now) {
+            if (scheduler == SchedulerMode::DEADLINE) {
+                process(slot, now);
+                return;
+            }
+            Base* t = tasks[slot].get();
+            const uint16_t generation = generations[slot];
+            t->update_recursive();
+            if ((generations[slot] != generation) || !tasks[slot]) return;
+            if (t->isStopping() && t->isAutoErase()) {
+                release(slot);
+                return;
+            }
+            // same as schedule() of SchedulerMode::DEADLINE
+            const int64_t due = t->getNextDueUsec64();
+            budget_due.get()[slot] = (due < 0) ? -1 : now + due;
+        }
+
+        // returns true if the task has been erased
+        bool process(const uint16_t slot, const int64_t now) {
+            Base* t = tasks[slot].get();
+            const uint16_t generation = generations[slot];
+            t->sched_tick = tick;
+            processing = t;
+            t->update_recursive();
+            processing = nullptr;
+            // erased inside of update(): the slot may already be reused by a new task
+            if ((generations[slot] != generation) || !tasks[slot]) return true;
+            if (t->isStopping() && t->isAutoErase()) {
+                release(slot);
+                return true;
+            }
+            schedule(slot, now);
+            return false;
         }
-        void startFpsForFrame(const double fps, const double for_frame, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsForFrame(fps, for_frame, loop);
+
+        void schedule(const uint16_t slot, const int64_t now) {
+            Base* t = tasks[slot].get();
+            const int64_t due = t->getNextDueUsec64();
+            if (due < 0) {
+                ++t->sched_seq;  // drop remaining entries until the task is controlled again
+            } else {
+                push_deadline(now + due, slot);
+            }
         }
 
-        void startFpsFromForSec(
-            const double fps, const double from_sec, const double for_sec, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsFromForSec(fps, from_sec, for_sec, loop);
+        // stopped tasks in idle_tasks are updated to call idle() (others are skipped)
+        void listen_idle(Base* t) {
+            if (t->b_idle_listed) return;
+            t->b_idle_listed = true;
+            idle_tasks.get().emplace_back(t->slot);
         }
-        void startFpsFromForMsec(
-            const double fps, const double from_ms, const double for_ms, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsFromForMsec(fps, from_ms, for_ms, loop);
+
+        // called from Base when its timer is controlled
+        void reschedule(Base* t) {
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            if (b_stagger) b_stagger_pending = true;
+#endif
+            if (scheduler != SchedulerMode::DEADLINE) {
+                mark_budget_due(t->slot);
+                return;
+            }
+            if (t == processing) return;
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+            if (b_dispatching) {
+                std::lock_guard<std::mutex> lock(resched_mtx);
+                resched_slots.emplace_back(t->slot);
+                return;
+            }
+#endif
+            push_deadline(now_usec64(), t->slot);
         }
-        void startFpsFromForUsec(
-            const double fps, const double from_us, const double for_us, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsFromForUsec(fps, from_us, for_us, loop);
+
+        void push_deadline(const int64_t due_us, const uint16_t slot) {
+            Base* t = tasks[slot].get();
+            const uint32_t seq = ++t->sched_seq;  // the previous entry of this task becomes stale
+            if (deadlines.size() >= heap_limit()) compact_deadlines();
+            Vec<Deadline>& heap = deadlines.get();
+            heap.emplace_back(Deadline {due_us, slot, generations[slot], seq});
+            sift_up(heap, heap.size() - 1);
         }
-        void startFpsFromForFrame(
-            const double fps, const double from_frame, const double for_frame, const bool loop = false) {
-            for (auto& t : tasks) t->startFpsFromForFrame(fps, from_frame, for_frame, loop);
+
+        // the heap is compacted when this size is reached by stale entries of repeated control
+        size_t heap_limit() const {
+            const size_t n = 2 * num_tasks + 8;
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            return n;
+#else
+            // arx::stdx::vector can't grow beyond its fixed storage (one valid entry per task always fits)
+            return (n < ARX_VECTOR_DEFAULT_SIZE) ? n : ARX_VECTOR_DEFAULT_SIZE;
+#endif
         }
 
-        void startOnce() {
-            for (auto& t : tasks) t->startOnce();
+        void compact_deadlines() {
+            Vec<Deadline>& heap = deadlines.get();
+            size_t n = 0;
+            for (size_t i = 0; i < heap.size(); ++i)
+                if (isValid(heap[i])) heap[n++] = heap[i];
+            heap.resize(n);
+            for (size_t i = n / 2; i > 0; --i) sift_down(heap, i - 1);
         }
-        void startOnceAfterSec(const double after_sec) {
-            for (auto& t : tasks) t->startOnceAfterSec(after_sec);
+
+        // containers of SchedulerMode::DEADLINE are allocated only in that mode
+        void reserve_deadline(const size_t n) {
+            deadlines.get().reserve(2 * n + 8);
+            due_tasks.get().reserve(n);
+            idle_tasks.get().reserve(n);
         }
-        void startOnceAfterMsec(const double after_ms) {
-            for (auto& t : tasks) t->startOnceAfterMsec(after_ms);
+
+        Deadline pop_deadline() {
+            Vec<Deadline>& heap = deadlines.get();
+            const Deadline d = heap[0];
+            heap[0] = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) sift_down(heap, 0);
+            return d;
         }
-        void startOnceAfterUsec(const double after_us) {
-            for (auto& t : tasks) t->startOnceAfterUsec(after_us);
+
+        static void sift_up(Vec<Deadline>& heap, size_t i) {
+            while (i > 0) {
+                const size_t p = (i - 1) / 2;
+                if (heap[p].due_us <= heap[i].due_us) break;
+                const Deadline d = heap[p];
+                heap[p] = heap[i];
+                heap[i] = d;
+                i = p;
+            }
         }
 
-        void stop() {
-            for (auto& t : tasks) t->stop();
+        static void sift_down(Vec<Deadline>& heap, size_t i) {
+            const size_t n = heap.size();
+            while (true) {
+                const size_t l = 2 * i + 1;
+                const size_t r = l + 1;
+                size_t m = i;
+                if ((l < n) && (heap[l].due_us < heap[m].due_us)) m = l;
+                if ((r < n) && (heap[r].due_us < heap[m].due_us)) m = r;
+                if (m == i) break;
+                const Deadline d = heap[m];
+                heap[m] = heap[i];
+                heap[i] = d;
+                i = m;
+            }
         }
 
-        void play() {
-            for (auto& t : tasks) t->play();
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        // move the first frames of started tasks to the least loaded phases of their families
+        void stagger() {
+            b_stagger_pending = false;
+            std::vector<StaggerTask> ts;
+            bool b_new = false;
+            for (auto& t : tasks) {
+                if (!t || t->b_event || !t->isRunning()) continue;
+                const double interval_us = t->getIntervalSec() * 1000000.;
+                if (interval_us <= 0.) continue;  // every update()
+                const bool b = t->hasEnter() && !t->hasOffset();
+                ts.emplace_back(StaggerTask {t.get(), interval_us, stagger_cost(*t), 1, b});
+                b_new = b_new || b;
+            }
+            if (!b_new) return;
+
+            std::stable_sort(ts.begin(), ts.end(), [](const StaggerTask& a, const StaggerTask& b) {
+                return a.interval_us < b.interval_us;
+            });
+            std::vector<bool> assigned(ts.size(), false);
+            std::vector<StaggerTask*> family;
+            const int64_t now = now_usec64();
+            for (size_t i = 0; i < ts.size(); ++i) {
+                if (assigned[i]) continue;
+                family.clear();
+                bool b_family_new = false;
+                for (size_t j = i; j < ts.size(); ++j) {
+                    if (assigned[j]) continue;
+                    const double r = ts[j].interval_us / ts[i].interval_us;
+                    const double n = floor(r + 0.5);
+                    if ((n > STAGGER_MAX_RATIO) || (fabs(r - n) > 1e-6 * n)) continue;
+                    ts[j].ratio = (uint32_t)n;
+                    assigned[j] = true;
+                    family.emplace_back(&ts[j]);
+                    b_family_new = b_family_new || ts[j].b_new;
+                }
+                if (b_family_new) stagger_family(family, ts[i].interval_us, now);
+            }
         }
 
-        void pause() {
-            for (auto& t : tasks) t->pause();
+        // the time of the family is divided into cells (slots x frames of the shortest interval until all repeat)
+        // and tasks are placed in order of cost to the phases whose busiest cell is least loaded
+        void stagger_family(std::vector<StaggerTask*>& family, const double base_us, const int64_t now) {
+            uint32_t frames = 1;
+            for (const StaggerTask* t : family) {
+                const uint32_t l = frames / gcd(frames, t->ratio) * t->ratio;
+                frames = (l <= STAGGER_MAX_RATIO) ? l : STAGGER_MAX_RATIO;  // phases repeat approximately if capped
+            }
+            const uint32_t slots = (family.size() < STAGGER_MAX_SLOTS) ? (uint32_t)family.size() : STAGGER_MAX_SLOTS;
+            const uint32_t cells = frames * slots;
+            const double cell_us = base_us / slots;
+            std::vector<uint32_t> load(cells, 0);
+
+            // tasks which are already running are fixed at the cell of their next frame
+            for (const StaggerTask* t : family) {
+                if (t->b_new) continue;
+                const double next_us = (double)(now + t->task->getFrameDueUsec64());
+                const uint32_t cell = (uint32_t)(fmod(next_us, base_us * frames) / cell_us) % cells;
+                for (uint32_t k = 0; k < cells; k += t->ratio * slots) load[(cell + k) % cells] += t->cost;
+            }
+
+            std::stable_sort(family.begin(), family.end(), [](const StaggerTask* a, const StaggerTask* b) {
+                return a->cost > b->cost;
+            });
+            for (StaggerTask* t : family) {
+                if (!t->b_new) continue;
+                const uint32_t period = t->ratio * slots;  // cells in the interval of this task
+                uint32_t best = 0;
+                uint64_t best_max = UINT64_MAX, best_sum = UINT64_MAX;
+                for (uint32_t c = 0; c < period; ++c) {
+                    uint64_t m = 0, sum = 0;
+                    for (uint32_t k = 0; k < cells; k += period) {
+                        const uint64_t l = (uint64_t)load[(c + k) % cells] + t->cost;
+                        if (l > m) m = l;
+                        sum += l;
+                    }
+                    if ((m < best_max) || ((m == best_max) && (sum < best_sum))) {
+                        best = c;
+                        best_max = m;
+                        best_sum = sum;
+                    }
+                }
+                for (uint32_t k = 0; k < cells; k += period) load[(best + k) % cells] += t->cost;
+
+                // delay the first frame (frame 0 runs when usec64() becomes 0) to the next time of the cell
+                double delay_us = fmod(best * cell_us - (double)now, t->interval_us);
+                if (delay_us < 0.) delay_us += t->interval_us;
+                t->task->setOffsetUsec64(-(t->task->usec64() + (int64_t)delay_us));
+            }
         }
 
-        void restart() {
-            for (auto& t : tasks) t->restart();
+        static uint32_t stagger_cost(const Base& t) {
+#ifdef TASKMANAGER_PROFILER_ENABLE
+            const Profile& p = t.getProfile();
+            const uint64_t us = p.recursive_calls ? (p.recursive_us / p.recursive_calls) : 0;
+            if (us > 0) return (us < 0xFFFF) ? (uint32_t)us : 0xFFFF;
+#endif
+            (void)t;
+            return 1;
         }
 
-        void setOffsetSec(const double sec) {
-            for (auto& t : tasks) t->setOffsetSec(sec);
+        static uint32_t gcd(uint32_t a, uint32_t b) {
+            while (b) {
+                const uint32_t r = a % b;
+                a = b;
+                b = r;
+            }
+            return a;
         }
-        void setOffsetMsec(const double ms) {
-            for (auto& t : tasks) t->setOffsetMsec(ms);
+#endif
+
+#ifdef TASKMANAGER_TRACE_ENABLE
+        // ids and names of a task and its subtasks for dumpTrace()
+        static uint32_t count_trace_names(const Base& t) {
+            uint32_t n = 1;
+            for (const auto& st : t.getSubTasks()) n += count_trace_names(*st);
+            return n;
         }
-        void setOffsetUsec(const double us) {
-            for (auto& t : tasks) t->setOffsetUsec(us);
+        static size_t write_trace_names(Print& p, const Base& t) {
+#ifdef TASKMANAGER_NAME_HASH
+            size_t n = Trace::writeName(p, t.trace_id, t.getName());
+#else
+            size_t n = Trace::writeName(p, t.trace_id, t.getName().c_str());
+#endif
+            for (const auto& st : t.getSubTasks()) n += write_trace_names(p, *st);
+            return n;
         }
-        void setOffsetUsec64(const int64_t us) {
-            for (auto& t : tasks) t->setOffsetUsec64(us);
+#endif
+
+        void monitor_load(const uint32_t begin_us, const bool b_busy) {
+            const uint32_t now = micros();
+            if (b_busy) load_busy_us += now - begin_us;
+            const uint32_t elapsed = now - load_window_begin_us;
+            if (elapsed < load_window_us) return;
+
+            load = (float)load_busy_us / (float)elapsed;
+            load_window_begin_us = now;
+            load_busy_us = 0;
+            ++load_stats.windows;
+            // one step in a window, and nothing between the thresholds (hysteresis)
+            if (load > load_high) {
+                ++load_stats.overloaded;
+                if (shed_load()) ++load_stats.degraded;
+            } else if (load < load_low) {
+                if (restore_load()) ++load_stats.restored;
+            }
         }
 
-        void addOffsetSec(const double sec) {
-            for (auto& t : tasks) t->addOffsetSec(sec);
+        // tasks whose frame rate can be changed by the load shedding
+        static bool is_adaptive(Base* t) {
+            return t && (t->preferred_fps > 0.f) && !t->b_event && !t->hasDuration() && t->isRunning();
         }
-        void addOffsetMsec(const double ms) {
-            for (auto& t : tasks) t->addOffsetMsec(ms);
+
+        // lower the frame rate of the adaptive tasks of the lowest priority which are above min_fps
+        bool shed_load() {
+            bool b_found = false;
+            uint8_t p = 0xFF;
+            for (auto& t : tasks) {
+                if (!is_adaptive(t.get()) || !t->is_above_min_fps()) continue;
+                if (t->priority <= p) p = t->priority;
+                b_found = true;
+            }
+            if (!b_found) return false;
+            for (auto& t : tasks) {
+                if (!is_adaptive(t.get()) || (t->priority != p)) continue;
+                const float fps = t->getFrameRate() * LOAD_STEP;
+                if (t->is_above_min_fps()) t->changeFrameRate((fps > t->min_fps) ? fps : t->min_fps);
+            }
+            return true;
         }
-        void addOffsetUsec(const double us) {
-            for (auto& t : tasks) t->addOffsetUsec(us);
+
+        // raise the frame rate of the degraded tasks of the highest priority
+        bool restore_load() {
+            bool b_found = false;
+            uint8_t p = 0;
+            for (auto& t : tasks) {
+                if (!is_adaptive(t.get()) || !t->isDegraded()) continue;
+                if (t->priority >= p) p = t->priority;
+                b_found = true;
+            }
+            if (!b_found) return false;
+            for (auto& t : tasks) {
+                if (!is_adaptive(t.get()) || (t->priority != p) || !t->isDegraded()) continue;
+                const float fps = t->getFrameRate() / LOAD_STEP;
+                t->changeFrameRate((fps < t->preferred_fps) ? fps : t->preferred_fps);
+            }
+            return true;
         }
-        void addOffsetUsec64(const int64_t us) {
-            for (auto& t : tasks) t->addOffsetUsec64(us);
+
+        int64_t now_usec64() {
+            const uint32_t us = micros();
+            if (us < prev_us) ++us_overflow;
+            prev_us = us;
+            return ((int64_t)us_overflow << 32) | (int64_t)us;
         }
+    };
+
+    // Tasks which are controlled together. Members are listed in the Manager,
+    // so Task method wrappers (startFps(), pause(), etc.) cost O(members) instead of O(all tasks).
+    //
+    //   Tasks.group("leds").add(led1);
+    //   Tasks.group("leds").add(led2);
+    //   Tasks.group("leds").startFps(30);
+    class Group : public BulkControl<Group> {
+        friend class BulkControl<Group>;
+        friend class Manager;
+
+        Manager* m {nullptr};
+        uint8_t id {0};
+
+        Group(Manager* m, const uint8_t id) : m(m), id(id) {}
 
-        void setDurationSec(const double sec) {
-            for (auto& t : tasks) t->setDurationSec(sec);
+    public:
+        Group() {}
+
+        // false if the group couldn't be created
+        explicit operator bool() const {
+            return m != nullptr;
         }
-        void setDurationMsec(const double ms) {
-            for (auto& t : tasks) t->setDurationMsec(ms);
+
+        // a task can be a member of multiple groups (only tasks added to the Manager, not subtasks)
+        bool add(const Handle<Base>& h) {
+            Base* t = m ? m->resolve(h.getSlot(), h.getGeneration()) : nullptr;
+            if (!t) return false;
+            const uint16_t bit = (uint16_t)(1 << id);
+            if (!(t->group_mask & bit)) {
+                t->group_mask |= bit;
+                slots().emplace_back(t->slot);
+            }
+            return true;
         }
-        void setDurationUsec(const double us) {
-            for (auto& t : tasks) t->setDurationUsec(us);
+        bool remove(const Handle<Base>& h) {
+            Base* t = m ? m->resolve(h.getSlot(), h.getGeneration()) : nullptr;
+            if (!t || !(t->group_mask & (1 << id))) return false;
+            m->leave_group(t, id);
+            return true;
         }
-        void setDurationUsec64(const int64_t us) {
-            for (auto& t : tasks) t->setDurationUsec64(us);
+        bool contains(const Handle<Base>& h) const {
+            Base* t = m ? m->resolve(h.getSlot(), h.getGeneration()) : nullptr;
+            return t && (t->group_mask & (1 << id));
         }
 
-        void setTimeSec(const double sec) {
-            for (auto& t : tasks) t->setTimeSec(sec);
-        }
-        void setTimeMsec(const double ms) {
-            for (auto& t : tasks) t->setTimeMsec(ms);
-        }
-        void setTimeUsec(const double us) {
-            for (auto& t : tasks) t->setTimeUsec(us);
+        size_t size() const {
+            return m ? (*m->groups)[id].slots.size() : 0;
         }
-        void setTimeUsec64(const int64_t us) {
-            for (auto& t : tasks) t->setTimeUsec64(us);
+        bool empty() const {
+            return size() == 0;
         }
 
-        void setLoop(const bool b) {
-            for (auto& t : tasks) t->setLoop(b);
+        // remove all members from this group (tasks are not erased)
+        void clear() {
+            if (!m) return;
+            Vec<uint16_t>& s = slots();
+            for (const uint16_t slot : s) m->tasks[slot]->group_mask &= ~(uint16_t)(1 << id);
+            s.clear();
+        }
+        // erase all members from the Manager
+        void erase() {
+            if (!m) return;
+            Vec<uint16_t>& s = slots();
+            while (!s.empty()) m->release(s.back());
+        }
+
+        // call f(Base&) for all members
+        template <typename F>
+        void forEach(F&& f) {
+            for_each_task(f);
+        }
+
+    private:
+        Vec<uint16_t>& slots() {
+            return m->groups.get()[id].slots;
+        }
+
+        // members may be erased (or added) by the task method (e.g. restart() calls update()),
+        // so the members are copied first and each one is checked again before it is called
+        struct Member {
+            uint16_t slot;
+            uint16_t generation;
+        };
+
+        template <typename F>
+        void for_each_task(F& f) {
+            if (!m) return;
+            Vec<Member> members;
+            members.reserve(slots().size());
+            for (const uint16_t slot : slots()) members.emplace_back(Member {slot, m->generations[slot]});
+            const uint16_t bit = (uint16_t)(1 << id);
+            for (const auto& member : members) {
+                Base* t = m->resolve(member.slot, member.generation);
+                if (t && (t->group_mask & bit)) f(*t);
+            }
         }
+    };
 
-        void setIntervalSec(const double sec) {
-            for (auto& t : tasks) t->setIntervalSec(sec);
-        }
-        void setIntervalMsec(const double ms) {
-            for (auto& t : tasks) t->setIntervalMsec(ms);
-        }
-        void setIntervalUsec(const double us) {
-            for (auto& t : tasks) t->setIntervalUsec(us);
-        }
-        void setIntervalUsec64(const int64_t us) {
-            for (auto& t : tasks) t->setIntervalUsec64(us);
+    inline Group Manager::group(const String& name) {
+        const auto& key = make_name(name);
+        for (size_t i = 0; i < groups.size(); ++i)
+            if (groups[i].name == key) return Group(this, (uint8_t)i);
+        if (groups.size() >= MAX_GROUPS) {
+            LOG_ERROR("Couldn't add group: number of groups exceeds", MAX_GROUPS);
+            return Group();
         }
+        groups.get().emplace_back(GroupEntry {key, Vec<uint16_t>()});
+        return Group(this, (uint8_t)(groups.size() - 1));
+    }
 
-        void setOffsetCount(const double count) {
-            for (auto& t : tasks) t->setOffsetCount(count);
-        }
+    inline void Base::reschedule() {
+        // the schedule (e.g. duration) of a subtask is changed from outside of its parent
+        if (parent && !parent->b_timeline_lock) parent->b_timeline_dirty = true;
+        Base* root = this;
+        while (root->parent) root = root->parent;
+        if (root->manager) root->manager->reschedule(root);
+    }
 
-        void setOffsetFrame(const double frame) {
-            for (auto& t : tasks) t->setOffsetFrame(frame);
-        }
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+    inline void Base::retire_subtask(const Ref<Base>& t) {
+        Base* root = this;
+        while (root->parent) root = root->parent;
+        if (root->manager)
+            root->manager->retire(t);  // the tree of the root may point to it inside of update()
+        else
+            delete t.get();
+    }
+#endif
+
+    inline void Base::listen_idle() {
+        Base* root = this;
+        while (root->parent) root = root->parent;
+        if (root->manager) root->manager->listen_idle(root);
+    }
 
-        void setFrameRate(const float fps) {
-            for (auto& t : tasks) t->setFrameRate(fps);
+    namespace detail {
+        inline Base* resolve_handle(const uint16_t slot, const uint16_t generation) {
+            return Manager::get().resolve(slot, generation);
         }
-    };
+        inline Ref<Base> resolve_handle_ref(const uint16_t slot, const uint16_t generation) {
+            return Manager::get().getTaskByHandle(Handle<Base>(slot, generation));
+        }
+    }  // namespace detail
 
 }  // namespace task
 }  // namespace arduino
@@ -555,8 +1683,12 @@ namespace Task = arduino::task;
 
 template <typename T>
 using TaskRef = Task::Ref<T>;
+template <typename T = Task::Base>
+using TaskHandle = Task::Handle<T>;
 using TaskBaseRef = TaskRef<Task::Base>;
 using SubTaskMode = Task::SubTaskMode;
+using SchedulerMode = Task::SchedulerMode;
+using OverrunPolicy = Task::OverrunPolicy;
 
 #include <DebugLogRestoreState.h>
 
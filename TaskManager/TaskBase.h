@@ -5,43 +5,189 @@
 #include <Arduino.h>
 #include <FrameRateCounter.h>
 
+#include "TaskHandle.h"
+#include "TaskLazy.h"
+#include "TaskNameIndex.h"
+#include "TaskProfiler.h"
+#include "TaskTrace.h"
+#include "TaskTraits.h"
+
 #ifndef TASKMANAGER_MAX_SUBTASKS
 #define TASKMANAGER_MAX_SUBTASKS 4
 #endif // TASKMANAGER_MAX_SUBTASKS
 
+// C++20 coroutines for Manager::spawn() (see TaskCoroutine.h)
+#if defined(__has_include) && defined(__cpp_impl_coroutine) && (ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L)
+#if __has_include(<coroutine>)
+#define TASKMANAGER_HAS_COROUTINE
+#endif
+#endif
+
 namespace arduino {
 namespace task {
 
     enum class SubTaskMode : uint8_t { NA, PARALLEL, SYNC, SEQUENCE };
 
+    // what happens to the frames which are missed because update() was called late (e.g. loop() was blocked)
+    enum class OverrunPolicy : uint8_t {
+        SKIP,      // update() once for the latest frame (default)
+        CATCH_UP,  // update() also for the missed frames (up to the limit)
+        REPHASE,   // update() once and restart the frame timing from now
+    };
+
     class Manager;
+    class Group;
     class TaskEmpty;
+    class Base;
+#ifdef TASKMANAGER_HAS_COROUTINE
+    class StopAwaiter;
+#endif
+
+    namespace detail {
+        // true if TaskType (or one of its bases other than Base) declares the hook
+        template <typename TaskType>
+        constexpr bool has_enter_hook() {
+            return !is_same<decltype(&TaskType::enter), void (Base::*)()>::value;
+        }
+        template <typename TaskType>
+        constexpr bool has_exit_hook() {
+            return !is_same<decltype(&TaskType::exit), void (Base::*)()>::value;
+        }
+        template <typename TaskType>
+        constexpr bool has_idle_hook() {
+            return !is_same<decltype(&TaskType::idle), void (Base::*)()>::value;
+        }
+    }  // namespace detail
 
     class Base : public FrameRateCounter {
         friend class Manager;
+        friend class Group;
+#ifdef TASKMANAGER_HAS_COROUTINE
+        friend class StopAwaiter;
+#endif
 
 #if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-        using SubTasks = std::vector<Ref<Base>>;
+        using SubTasks = Vec<Ref<Base>>;
+        using Timeline = Vec<int64_t>;
+
+        // pre-order array of the subtask tree (only in the root task)
+        // the subtree of tree[i] is tree[i + 1] ... tree[tree[i].next - 1]
+        struct TreeNode {
+            Ref<Base> task;   // kept alive until the tree is rebuilt even if it is erased while the tree is updated
+            uint16_t parent;  // index of the parent node (TREE_ROOT: root task)
+            uint16_t next;    // index of the next sibling (end of the subtree)
+            uint16_t index;   // index in the subtasks of the parent
+        };
+        using Tree = Vec<TreeNode>;
+        static constexpr uint16_t TREE_ROOT = 0xFFFF;
 #else
         using SubTasks = arx::stdx::vector<Ref<Base>, TASKMANAGER_MAX_SUBTASKS>;
+        using Timeline = arx::stdx::vector<int64_t, TASKMANAGER_MAX_SUBTASKS + 1>;
 #endif
 
     protected:
-        String name;
-        bool b_auto_erase {false};
+        // members are ordered by size to minimize padding (see extras/host/footprint for sizeof(Base))
+        TaskName name;  // String, or 32-bit hash with TASKMANAGER_NAME_HASH
+
+        // for SubTask (containers are allocated when the first subtask is added)
+        Lazy<SubTasks> subtasks;
+        // only for SubTaskMode::SEQUENCE: start time [us] of each subtask (prefix sums of durations)
+        Lazy<Timeline> timeline;
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        Lazy<NameIndex<Ref<Base>>> subtask_names;
+        Lazy<Tree> tree;
+#endif
+        Base* parent {nullptr};
+
+        // for Manager
+        Manager* manager {nullptr};
+        uint32_t sched_seq {0};
+        uint32_t sched_tick {0};
+
+        // for Manager::setLoadShedding() (preferred_fps is 0 if the rate of this task is not adaptive)
+        float preferred_fps {0.f};
+        float min_fps {0.f};
+#ifdef TASKMANAGER_PROFILER_ENABLE
+        Profile profile;
+#endif
+#ifdef TASKMANAGER_TRACE_ENABLE
+        uint32_t trace_id;  // id of this instance in TraceEvents (names may be duplicated or empty)
+#endif
+#ifdef TASKMANAGER_HAS_COROUTINE
+        Lazy<Vec<Handle<Base>>> stop_waiters;  // coroutines which co_await stopped() (allocated by the first one)
+#endif
+        uint16_t slot {0};
+        uint16_t budget_wait {0};  // number of updateWithBudget() calls which deferred this task
+        uint16_t group_mask {0};   // bit i: member of Manager::groups[i]
+
+        // for startOnEvent()
+        uint16_t num_notified {0};  // notify() calls coalesced into the next update()
+        uint16_t notify_count {0};  // notify() calls coalesced into the current update()
 
-        // for SubTask
-        SubTasks subtasks;
+        // for OverrunPolicy (saturated at 0xFFFF)
+        uint16_t missed_frames {0};     // frames which were due while update() was not called
+        uint16_t coalesced_frames {0};  // missed frames which didn't get their own update()
+
+        uint16_t subtask_index {0};  // only for SubTaskMode::SEQUENCE
         SubTaskMode mode {SubTaskMode::NA};
-        size_t subtask_index {0};  // only for SubTaskMode::SEQUENCE
+        uint8_t priority {0};         // higher runs first in Manager::updateWithBudget()
+        uint8_t max_catch_up {0};     // only for OverrunPolicy::CATCH_UP
+        OverrunPolicy overrun_policy {OverrunPolicy::SKIP};
+
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+        int8_t affinity {-1};  // worker index (-1: any worker)
+#endif
+
+        // flags (initialized in the constructor because bit-fields can't have default member initializers in C++11)
+        // lifecycle hooks which are overridden (all hooks are called until detected on registration)
+        enum : uint8_t { HOOK_ENTER = 0x01, HOOK_EXIT = 0x02, HOOK_IDLE = 0x04, HOOK_ALL = 0x07 };
+        uint8_t hooks : 3;
+        bool b_auto_erase : 1;
+        bool b_event : 1;           // for startOnEvent()
+        bool b_notified : 1;        // for startOnEvent()
+        bool b_timeline_dirty : 1;  // rebuilt when subtasks are added or controlled from outside
+        bool b_timeline_fixed : 1;  // all subtasks have duration
+        bool b_timeline_lock : 1;   // subtasks are controlled by this task itself
+        bool b_erase_pending : 1;   // only for SubTaskMode::PARALLEL: stopped subtask with auto erase
+        bool b_tree_dirty : 1;      // rebuilt when subtasks are added or erased at any depth (only in the root task)
+        bool b_budget_pending : 1;
+        bool b_subtask_idle_hook : 1;  // one of subtasks overrides idle()
+        bool b_idle_listed : 1;        // in Manager::idle_tasks
+        bool b_main_thread : 1;        // only for TASKMANAGER_EXECUTOR_ENABLE
 
     public:
-        Base(const String& name) : FrameRateCounter(), name(name) { subtasks.reserve(4); }
+        Base(const String& name)
+            : FrameRateCounter(), name(make_name(name)), hooks(HOOK_ALL), b_auto_erase(false), b_event(false),
+              b_notified(false), b_timeline_dirty(true), b_timeline_fixed(false), b_timeline_lock(false),
+              b_erase_pending(false), b_tree_dirty(true), b_budget_pending(false), b_subtask_idle_hook(false),
+              b_idle_listed(false), b_main_thread(false) {
+#ifdef TASKMANAGER_TRACE_ENABLE
+            trace_id = Trace::get().nextId();
+#endif
+        }
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+        // subtasks are owned by this task
+        Base(const Base&) = delete;
+        Base& operator=(const Base&) = delete;
+        virtual ~Base() {
+            for (auto& st : subtasks) delete st.get();
+        }
+#ifdef TASKMANAGER_POOL_SIZE
+        // the size of the derived class is given to sized delete by the virtual destructor
+        static void* operator new(const size_t n) {
+            return Pool::allocate(n);
+        }
+        static void operator delete(void* p, const size_t n) {
+            Pool::deallocate(p, n);
+        }
+#endif
+#else
         Base(const Base&) = default;
         Base& operator=(const Base&) = default;
         Base(Base&&) = default;
         Base& operator=(Base&&) = default;
         virtual ~Base() = default;
+#endif
 
         virtual void begin() {};
         virtual void enter() {};
@@ -52,8 +198,11 @@ namespace task {
 
         virtual void stop() override {
             FrameRateCounter::stop();
+            b_timeline_lock = true;
             for (auto& st : subtasks) st->stop();
+            b_timeline_lock = false;
             subtask_index = 0;
+            reschedule();
         }
 
         virtual void restart() override {
@@ -63,17 +212,35 @@ namespace task {
             }
             this->stop();
             if (hasExit()) exit_recursive();
+            // FrameRateCounter::restart() calls start*() of this class which switch to time-driven
+            const bool b_event_triggered = b_event;
             FrameRateCounter::restart();
+            if (b_event_triggered) {
+                b_event = true;
+                b_notified = false;
+                num_notified = 0;
+            }
             if (hasEnter()) enter_recursive();
             releaseEventTrigger();  // disable hasExit()
+            reschedule();
         }
 
         virtual void clear() override {
             stop();
-            subtasks.clear();
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+            for (auto& st : subtasks) retire_subtask(st);
+#endif
+            subtasks.reset();
+            timeline.reset();
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            subtask_names.reset();
+            mark_tree_dirty();  // the tree is rebuilt in the next update() because it may be being updated now
+#endif
+            b_timeline_dirty = true;
             mode = SubTaskMode::NA;
             subtask_index = 0;
             FrameRateCounter::clear();
+            reschedule();
         }
 
         bool hasEnter() const {
@@ -85,16 +252,586 @@ namespace task {
 
         Base* setAutoErase(const bool b) {
             b_auto_erase = b;
+            reschedule();
             return this;
         }
         bool isAutoErase() const {
             return b_auto_erase;
         }
 
-        const String& getName() const {
+        Base* setPriority(const uint8_t p) {
+            priority = p;
+            return this;
+        }
+        uint8_t getPriority() const {
+            return priority;
+        }
+
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+        // run this task always on the worker (-1: any worker)
+        Base* setAffinity(const int8_t worker) {
+            affinity = worker;
+            return this;
+        }
+        int8_t getAffinity() const {
+            return affinity;
+        }
+        // run this task on the thread which calls Tasks.update() (e.g. it controls other tasks)
+        Base* setMainThread(const bool b) {
+            b_main_thread = b;
+            return this;
+        }
+        bool isMainThread() const {
+            return b_main_thread;
+        }
+#endif
+
+        const TaskName& getName() const {
             return name;
         }
 
+#ifdef TASKMANAGER_PROFILER_ENABLE
+        const Profile& getProfile() const {
+            return profile;
+        }
+        void resetProfile() {
+            profile.reset();
+            for (auto& st : subtasks) st->resetProfile();
+        }
+#endif
+#ifdef TASKMANAGER_TRACE_ENABLE
+        // id of this task in the dump of Manager::dumpTrace()
+        uint32_t getTraceId() const {
+            return trace_id;
+        }
+#endif
+
+        // ========== Event-triggered task ==========
+
+        // update() is called only once after notify() (multiple notify() are coalesced)
+        // calling other start methods switches the task back to time-driven (restart() doesn't)
+        Base* startOnEvent() {
+            FrameRateCounter::start();
+            b_event = true;
+            b_notified = false;
+            num_notified = 0;
+            reschedule();
+            return this;
+        }
+        bool isEventTriggered() const {
+            return b_event;
+        }
+
+        Base* notify() {
+            if (num_notified < 0xFFFF) ++num_notified;
+            if (!b_notified) {
+                b_notified = true;
+                reschedule();
+            }
+            return this;
+        }
+        bool isNotified() const {
+            return b_notified;
+        }
+        // number of notify() coalesced into this update()
+        uint16_t getNotifyCount() const {
+            return notify_count;
+        }
+
+#ifdef TASKMANAGER_HAS_COROUTINE
+        // co_await task->stopped() in the coroutine resumes it after this task exits
+        StopAwaiter stopped();
+#endif
+
+        // ========== Overrun policy ==========
+
+        // CATCH_UP calls update() up to max_catch_up more times in the same update() of the Manager
+        // (frame() is the latest frame in all calls)
+        Base* setOverrunPolicy(const OverrunPolicy p, const uint8_t max_catch_up = 0xFF) {
+            overrun_policy = p;
+            this->max_catch_up = max_catch_up;
+            return this;
+        }
+        OverrunPolicy getOverrunPolicy() const {
+            return overrun_policy;
+        }
+        // frames which were due while update() was not called (e.g. 3 if update() is called 4 frames late)
+        uint16_t getMissedFrames() const {
+            return missed_frames;
+        }
+        // missed frames which didn't get their own update() (all of them except caught up ones)
+        uint16_t getCoalescedFrames() const {
+            return coalesced_frames;
+        }
+        void resetOverrunCounts() {
+            missed_frames = 0;
+            coalesced_frames = 0;
+        }
+
+        // ========== Load shedding ==========
+
+        // the Manager lowers the frame rate of this task down to min_fps when update() is overloaded
+        // (see Manager::setLoadShedding(), tasks of lower priority first) and raises it back to preferred_fps
+        Base* setAdaptiveFps(const float preferred_fps, const float min_fps) {
+            this->preferred_fps = preferred_fps;
+            this->min_fps = (min_fps < preferred_fps) ? min_fps : preferred_fps;
+            if ((getFrameRate() < preferred_fps * 0.999f) || (getFrameRate() > preferred_fps * 1.001f))
+                changeFrameRate(preferred_fps);
+            return this;
+        }
+        float getPreferredFps() const {
+            return preferred_fps;
+        }
+        float getMinFps() const {
+            return min_fps;
+        }
+        // true if the frame rate is lowered by the Manager (the current rate is getFrameRate())
+        bool isDegraded() {
+            return (preferred_fps > 0.f) && (getFrameRate() < preferred_fps * 0.999f);  // ignore rounding of interval
+        }
+
+        // change the frame rate of the running task without jumping frame() (the current frame keeps its progress)
+        void changeFrameRate(const float fps) {
+            const double interval_us = getIntervalSec() * 1000000.;
+            if (!isRunning() || (interval_us <= 0.)) {
+                setFrameRate(fps);
+                return;
+            }
+            const double progress = (double)usec64() / interval_us;  // in frames
+            FrameRateCounter::setFrameRate(fps);
+            setTimeUsec64((int64_t)(progress * getIntervalSec() * 1000000.));
+            reschedule();
+        }
+
+        // ========== FrameRateCounter method wrappers ==========
+        // these notify the Manager so that SchedulerMode::DEADLINE can requeue the task
+
+        void start() {
+            b_event = false;
+            FrameRateCounter::start();
+            reschedule();
+        }
+
+        void startFromSec(const double from_sec) {
+            b_event = false;
+            FrameRateCounter::startFromSec(from_sec);
+            reschedule();
+        }
+        void startFromMsec(const double from_ms) {
+            b_event = false;
+            FrameRateCounter::startFromMsec(from_ms);
+            reschedule();
+        }
+        void startFromUsec(const double from_us) {
+            b_event = false;
+            FrameRateCounter::startFromUsec(from_us);
+            reschedule();
+        }
+
+        void startForSec(const double for_sec, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startForSec(for_sec, loop);
+            reschedule();
+        }
+        void startForMsec(const double for_ms, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startForMsec(for_ms, loop);
+            reschedule();
+        }
+        void startForUsec(const double for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startForUsec(for_us, loop);
+            reschedule();
+        }
+
+        void startFromForSec(const double from_sec, const double for_sec, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFromForSec(from_sec, for_sec, loop);
+            reschedule();
+        }
+        void startFromForMsec(const double from_ms, const double for_ms, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFromForMsec(from_ms, for_ms, loop);
+            reschedule();
+        }
+        void startFromForUsec(const double from_us, const double for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFromForUsec(from_us, for_us, loop);
+            reschedule();
+        }
+        void startFromForUsec64(const int64_t from_us, const int64_t for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFromForUsec64(from_us, for_us, loop);
+            reschedule();
+        }
+
+        void startFromCount(const double from_count) {
+            b_event = false;
+            FrameRateCounter::startFromCount(from_count);
+            reschedule();
+        }
+
+        void startForCount(const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startForCount(for_count, loop);
+            reschedule();
+        }
+
+        void startFromForCount(const double from_count, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFromForCount(from_count, for_count, loop);
+            reschedule();
+        }
+
+        void startIntervalSec(const double interval_sec) {
+            b_event = false;
+            FrameRateCounter::startIntervalSec(interval_sec);
+            reschedule();
+        }
+        void startIntervalMsec(const double interval_ms) {
+            b_event = false;
+            FrameRateCounter::startIntervalMsec(interval_ms);
+            reschedule();
+        }
+        void startIntervalUsec(const double interval_us) {
+            b_event = false;
+            FrameRateCounter::startIntervalUsec(interval_us);
+            reschedule();
+        }
+
+        void startIntervalFromSec(const double interval_sec, const double from_sec) {
+            b_event = false;
+            FrameRateCounter::startIntervalFromSec(interval_sec, from_sec);
+            reschedule();
+        }
+        void startIntervalFromMsec(const double interval_ms, const double from_ms) {
+            b_event = false;
+            FrameRateCounter::startIntervalFromMsec(interval_ms, from_ms);
+            reschedule();
+        }
+        void startIntervalFromUsec(const double interval_us, const double from_us) {
+            b_event = false;
+            FrameRateCounter::startIntervalFromUsec(interval_us, from_us);
+            reschedule();
+        }
+
+        void startIntervalSecFromCount(const double interval_sec, const double from_count) {
+            b_event = false;
+            FrameRateCounter::startIntervalSecFromCount(interval_sec, from_count);
+            reschedule();
+        }
+        void startIntervalMsecFromCount(const double interval_ms, const double from_count) {
+            b_event = false;
+            FrameRateCounter::startIntervalMsecFromCount(interval_ms, from_count);
+            reschedule();
+        }
+        void startIntervalUsecFromCount(const double interval_us, const double from_count) {
+            b_event = false;
+            FrameRateCounter::startIntervalUsecFromCount(interval_us, from_count);
+            reschedule();
+        }
+
+        void startIntervalForSec(const double interval_sec, const double for_sec, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalForSec(interval_sec, for_sec, loop);
+            reschedule();
+        }
+        void startIntervalForMsec(const double interval_ms, const double for_ms, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalForMsec(interval_ms, for_ms, loop);
+            reschedule();
+        }
+        void startIntervalForUsec(const double interval_us, const double for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalForUsec(interval_us, for_us, loop);
+            reschedule();
+        }
+
+        void startIntervalSecForCount(const double interval_sec, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalSecForCount(interval_sec, for_count, loop);
+            reschedule();
+        }
+        void startIntervalMsecForCount(const double interval_ms, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalMsecForCount(interval_ms, for_count, loop);
+            reschedule();
+        }
+        void startIntervalUsecForCount(const double interval_us, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalUsecForCount(interval_us, for_count, loop);
+            reschedule();
+        }
+
+        void startIntervalFromForSec(
+            const double interval_sec, const double from_sec, const double for_sec, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalFromForSec(interval_sec, from_sec, for_sec, loop);
+            reschedule();
+        }
+        void startIntervalFromForMsec(
+            const double interval_ms, const double from_ms, const double for_ms, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalFromForMsec(interval_ms, from_ms, for_ms, loop);
+            reschedule();
+        }
+        void startIntervalFromForUsec(
+            const double interval_us, const double from_us, const double for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalFromForUsec(interval_us, from_us, for_us, loop);
+            reschedule();
+        }
+
+        void startIntervalSecFromForCount(
+            const double interval_sec, const double from_count, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalSecFromForCount(interval_sec, from_count, for_count, loop);
+            reschedule();
+        }
+        void startIntervalMsecFromForCount(
+            const double interval_ms, const double from_count, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalMsecFromForCount(interval_ms, from_count, for_count, loop);
+            reschedule();
+        }
+        void startIntervalUsecFromForCount(
+            const double interval_us, const double from_count, const double for_count, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startIntervalUsecFromForCount(interval_us, from_count, for_count, loop);
+            reschedule();
+        }
+
+        void startFromFrame(const double from_frame) {
+            b_event = false;
+            FrameRateCounter::startFromFrame(from_frame);
+            reschedule();
+        }
+
+        void startForFrame(const double for_frame, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startForFrame(for_frame, loop);
+            reschedule();
+        }
+
+        void startFromForFrame(const double from_frame, const double for_frame, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFromForFrame(from_frame, for_frame, loop);
+            reschedule();
+        }
+
+        void startFps(const double fps) {
+            b_event = false;
+            FrameRateCounter::startFps(fps);
+            reschedule();
+        }
+
+        void startFpsFromSec(const double fps, const double from_sec) {
+            b_event = false;
+            FrameRateCounter::startFpsFromSec(fps, from_sec);
+            reschedule();
+        }
+        void startFpsFromMsec(const double fps, const double from_ms) {
+            b_event = false;
+            FrameRateCounter::startFpsFromMsec(fps, from_ms);
+            reschedule();
+        }
+        void startFpsFromUsec(const double fps, const double from_us) {
+            b_event = false;
+            FrameRateCounter::startFpsFromUsec(fps, from_us);
+            reschedule();
+        }
+
+        void startFpsFromFrame(const double fps, const double from_frame) {
+            b_event = false;
+            FrameRateCounter::startFpsFromFrame(fps, from_frame);
+            reschedule();
+        }
+
+        void startFpsForSec(const double fps, const double for_sec, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsForSec(fps, for_sec, loop);
+            reschedule();
+        }
+        void startFpsForMsec(const double fps, const double for_ms, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsForMsec(fps, for_ms, loop);
+            reschedule();
+        }
+        void startFpsForUsec(const double fps, const double for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsForUsec(fps, for_us, loop);
+            reschedule();
+        }
+
+        void startFpsForFrame(const double fps, const double for_frame, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsForFrame(fps, for_frame, loop);
+            reschedule();
+        }
+
+        void startFpsFromForSec(
+            const double fps, const double from_sec, const double for_sec, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsFromForSec(fps, from_sec, for_sec, loop);
+            reschedule();
+        }
+        void startFpsFromForMsec(
+            const double fps, const double from_ms, const double for_ms, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsFromForMsec(fps, from_ms, for_ms, loop);
+            reschedule();
+        }
+        void startFpsFromForUsec(
+            const double fps, const double from_us, const double for_us, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsFromForUsec(fps, from_us, for_us, loop);
+            reschedule();
+        }
+
+        void startFpsFromForFrame(
+            const double fps, const double from_frame, const double for_frame, const bool loop = false) {
+            b_event = false;
+            FrameRateCounter::startFpsFromForFrame(fps, from_frame, for_frame, loop);
+            reschedule();
+        }
+
+        void startOnce() {
+            b_event = false;
+            FrameRateCounter::startOnce();
+            reschedule();
+        }
+
+        void startOnceAfterSec(const double after_sec) {
+            b_event = false;
+            FrameRateCounter::startOnceAfterSec(after_sec);
+            reschedule();
+        }
+        void startOnceAfterMsec(const double after_ms) {
+            b_event = false;
+            FrameRateCounter::startOnceAfterMsec(after_ms);
+            reschedule();
+        }
+        void startOnceAfterUsec(const double after_us) {
+            b_event = false;
+            FrameRateCounter::startOnceAfterUsec(after_us);
+            reschedule();
+        }
+
+        void play() {
+            FrameRateCounter::play();
+            reschedule();
+        }
+
+        void pause() {
+            FrameRateCounter::pause();
+            reschedule();
+        }
+
+        void setOffsetSec(const double sec) {
+            FrameRateCounter::setOffsetSec(sec);
+            reschedule();
+        }
+        void setOffsetMsec(const double ms) {
+            FrameRateCounter::setOffsetMsec(ms);
+            reschedule();
+        }
+        void setOffsetUsec(const double us) {
+            FrameRateCounter::setOffsetUsec(us);
+            reschedule();
+        }
+        void setOffsetUsec64(const int64_t us) {
+            FrameRateCounter::setOffsetUsec64(us);
+            reschedule();
+        }
+
+        void addOffsetSec(const double sec) {
+            FrameRateCounter::addOffsetSec(sec);
+            reschedule();
+        }
+        void addOffsetMsec(const double ms) {
+            FrameRateCounter::addOffsetMsec(ms);
+            reschedule();
+        }
+        void addOffsetUsec(const double us) {
+            FrameRateCounter::addOffsetUsec(us);
+            reschedule();
+        }
+        void addOffsetUsec64(const int64_t us) {
+            FrameRateCounter::addOffsetUsec64(us);
+            reschedule();
+        }
+
+        void setDurationSec(const double sec) {
+            FrameRateCounter::setDurationSec(sec);
+            reschedule();
+        }
+        void setDurationMsec(const double ms) {
+            FrameRateCounter::setDurationMsec(ms);
+            reschedule();
+        }
+        void setDurationUsec(const double us) {
+            FrameRateCounter::setDurationUsec(us);
+            reschedule();
+        }
+        void setDurationUsec64(const int64_t us) {
+            FrameRateCounter::setDurationUsec64(us);
+            reschedule();
+        }
+
+        void setTimeSec(const double sec) {
+            FrameRateCounter::setTimeSec(sec);
+            reschedule();
+        }
+        void setTimeMsec(const double ms) {
+            FrameRateCounter::setTimeMsec(ms);
+            reschedule();
+        }
+        void setTimeUsec(const double us) {
+            FrameRateCounter::setTimeUsec(us);
+            reschedule();
+        }
+        void setTimeUsec64(const int64_t us) {
+            FrameRateCounter::setTimeUsec64(us);
+            reschedule();
+        }
+
+        void setLoop(const bool b) {
+            FrameRateCounter::setLoop(b);
+            reschedule();
+        }
+
+        void setIntervalSec(const double sec) {
+            FrameRateCounter::setIntervalSec(sec);
+            reschedule();
+        }
+        void setIntervalMsec(const double ms) {
+            FrameRateCounter::setIntervalMsec(ms);
+            reschedule();
+        }
+        void setIntervalUsec(const double us) {
+            FrameRateCounter::setIntervalUsec(us);
+            reschedule();
+        }
+        void setIntervalUsec64(const int64_t us) {
+            FrameRateCounter::setIntervalUsec64(us);
+            reschedule();
+        }
+
+        void setOffsetCount(const double count) {
+            FrameRateCounter::setOffsetCount(count);
+            reschedule();
+        }
+
+        void setOffsetFrame(const double frame) {
+            FrameRateCounter::setOffsetFrame(frame);
+            reschedule();
+        }
+
+        void setFrameRate(const float fps) {
+            FrameRateCounter::setFrameRate(fps);
+            reschedule();
+        }
+
         // =========== for SubTask ==========
 
         template <typename TaskType>
@@ -108,9 +845,10 @@ namespace task {
                 return nullptr;
             }
             setSubTaskMode(SubTaskMode::PARALLEL);
-            Ref<TaskType> t = std::make_shared<TaskType>(name);
-            subtasks.emplace_back(t);
-            subtasks.shrink_to_fit();
+            Ref<TaskType> t = make_task<TaskType>(name);
+            t->parent = this;
+            t->template detect_hooks<TaskType>();
+            add_subtask(t);
             t->begin();
             setup(t);
             return this;
@@ -127,9 +865,10 @@ namespace task {
                 return nullptr;
             }
             setSubTaskMode(SubTaskMode::SYNC);
-            Ref<TaskType> t = std::make_shared<TaskType>(name);
-            subtasks.emplace_back(t);
-            subtasks.shrink_to_fit();
+            Ref<TaskType> t = make_task<TaskType>(name);
+            t->parent = this;
+            t->template detect_hooks<TaskType>();
+            add_subtask(t);
             t->begin();
             setup(t);
             return this;
@@ -154,9 +893,10 @@ namespace task {
                 return nullptr;
             }
             setSubTaskMode(SubTaskMode::SEQUENCE);
-            Ref<TaskType> t = std::make_shared<TaskType>(name);
-            subtasks.emplace_back(t);
-            subtasks.shrink_to_fit();
+            Ref<TaskType> t = make_task<TaskType>(name);
+            t->parent = this;
+            t->template detect_hooks<TaskType>();
+            add_subtask(t);
             t->setDurationSec(sec);
             t->begin();
             setup(t);
@@ -168,14 +908,14 @@ namespace task {
         }
 
         SubTasks& getSubTasks() {
-            return subtasks;
+            return subtasks.get();
         }
         const SubTasks& getSubTasks() const {
-            return subtasks;
+            return *subtasks;
         }
 
         Base* setSubTaskIndex(const size_t i) {
-            subtask_index = i;
+            subtask_index = (uint16_t)i;
             return this;
         }
         size_t getSubTaskIndex() const {
@@ -202,19 +942,25 @@ namespace task {
         }
 
         bool existsSubTask(const String& name) const {
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            return subtask_names->find(make_name(name)) != subtask_names->end();
+#else
+            const auto& key = make_name(name);
             for (auto& t : subtasks)
-                if (t->getName() == name) return true;
+                if (t->getName() == key) return true;
             return false;
+#endif
         }
 
         template <typename TaskType = Base>
         Ref<TaskType> getSubTaskByName(const String& name) const {
-            for (auto& t : subtasks)
-                if (t->getName() == name)
 #if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-                    return std::static_pointer_cast<TaskType>(t);
+            auto it = subtask_names->find(make_name(name));
+            if (it != subtask_names->end()) return detail::ref_cast<TaskType>(it->second);
 #else
-                    return (Ref<TaskType>)t;
+            const auto& key = make_name(name);
+            for (auto& t : subtasks)
+                if (t->getName() == key) return detail::ref_cast<TaskType>(t);
 #endif
             LOG_ERROR("No task found named", name);
             return nullptr;
@@ -227,11 +973,7 @@ namespace task {
                 return nullptr;
             }
 
-#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-            return std::static_pointer_cast<TaskType>(subtasks[i]);
-#else
-            return (Ref<TaskType>)subtasks[i];
-#endif
+            return detail::ref_cast<TaskType>(subtasks[i]);
         }
 
         template <typename TaskType = Base>
@@ -260,7 +1002,355 @@ namespace task {
             }
         }
 
+        // jump to the time in the sequence (all subtasks should have duration)
+        // the current subtask exits, the subtask at the time enters and its time is set to the local time
+        bool seekSec(const double sec) {
+            return seekUsec64((int64_t)(sec * 1000000.));
+        }
+        bool seekMsec(const double ms) {
+            return seekUsec64((int64_t)(ms * 1000.));
+        }
+        bool seekUsec(const double us) {
+            return seekUsec64((int64_t)us);
+        }
+        bool seekUsec64(int64_t us) {
+            if (mode != SubTaskMode::SEQUENCE) {
+                LOG_ERROR("Couldn't seek: SubTaskMode should be SEQUENCE");
+                return false;
+            }
+            if (!hasFixedSubTaskDuration()) {
+                LOG_ERROR("Couldn't seek: all subtasks should have duration");
+                return false;
+            }
+            if (isStopping()) {
+                LOG_ERROR("Couldn't seek: task is not running");
+                return false;
+            }
+            if (hasEnter()) {
+                releaseEventTrigger();  // disable hasExit()
+                enter_recursive();
+            }
+
+            const int64_t total_us = timeline[numSubTasks()];
+            if (us < 0) us = 0;
+            if (us >= total_us) us = total_us - 1;  // stay at the end of the last subtask
+            const size_t idx = findSubTaskAt(us);
+
+            b_timeline_lock = true;
+            setTimeUsec64(us);
+            if ((idx == subtask_index) && subtasks[idx]->isRunning()) {
+                subtasks[idx]->setTimeUsec64(us - timeline[idx]);
+            } else {
+                auto st = subtasks[subtask_index];
+                if (st->isRunning()) st->stop();
+                if (st->hasExit()) {
+                    st->releaseEventTrigger();  // disable hasExit()
+                    st->exit_recursive();
+                }
+                startSubTask(idx);
+            }
+            b_timeline_lock = false;
+            return true;
+        }
+
+        // total duration [sec] of the sequence (0 if some subtasks don't have duration)
+        double getSequenceDurationSec() {
+            if ((mode != SubTaskMode::SEQUENCE) || !hasFixedSubTaskDuration()) return 0.;
+            return (double)timeline[numSubTasks()] * 0.000001;
+        }
+
     private:
+        void reschedule();
+        void listen_idle();  // let the Manager call idle_recursive() of the root task
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        void mark_tree_dirty() {
+            Base* root = this;
+            while (root->parent) root = root->parent;
+            root->b_tree_dirty = true;
+        }
+#endif
+
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+        void retire_subtask(const Ref<Base>& t);  // delete the subtask which is removed from subtasks
+#endif
+
+        void add_subtask(const Ref<Base>& t) {
+            if ((t->hooks & HOOK_IDLE) && !b_subtask_idle_hook) {
+                b_subtask_idle_hook = true;
+                listen_idle();
+            }
+            subtasks.get().emplace_back(t);
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            subtask_names.get().emplace(t->getName(), t);  // keeps the first one if the name is duplicated
+            mark_tree_dirty();
+#endif
+            b_timeline_dirty = true;
+        }
+
+        typename SubTasks::iterator erase_subtask(typename SubTasks::iterator it) {
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+            const Ref<Base> t = *it;
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+            retire_subtask(t);
+#endif
+            auto& names = subtask_names.get();
+            auto idx = names.find(t->getName());
+            const bool b_indexed = (idx != names.end()) && (idx->second == t);
+            it = subtasks.get().erase(it);
+            if (b_indexed) {
+                names.erase(idx);
+                for (auto& st : subtasks) {
+                    if (st->getName() == t->getName()) {
+                        names.emplace(st->getName(), st);
+                        break;
+                    }
+                }
+            }
+            b_timeline_dirty = true;
+            mark_tree_dirty();
+            return it;
+#else
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+            retire_subtask(*it);
+#endif
+            b_timeline_dirty = true;
+            return subtasks.get().erase(it);
+#endif
+        }
+
+        template <typename TaskType>
+        void detect_hooks() {
+            hooks = (detail::has_enter_hook<TaskType>() ? HOOK_ENTER : 0)
+                  | (detail::has_exit_hook<TaskType>() ? HOOK_EXIT : 0)
+                  | (detail::has_idle_hook<TaskType>() ? HOOK_IDLE : 0);
+        }
+
+        // true if idle_recursive() has something to call
+        bool hasIdleHook() const {
+            return (hooks & HOOK_IDLE) || b_subtask_idle_hook;
+        }
+
+        // stopped task which has nothing to do in update_recursive() (checked without reading the clock)
+        bool isDormant() const {
+            return !hasIdleHook() && !b_auto_erase && isStopping() && !hasExit();
+        }
+
+        // running event-triggered task which is waiting for notify()
+        bool isEventIdle() {
+            return b_event && !b_notified && isRunning() && !hasEnter();
+        }
+
+        // for Manager::setLoadShedding()
+        bool is_above_min_fps() {
+            return getFrameRate() > min_fps * 1.001f;
+        }
+
+        // number of update() calls of all tasks (the Manager checks if update() did something)
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+        using UpdateCounter = std::atomic<uint32_t>;
+#else
+        using UpdateCounter = uint32_t;
+#endif
+        static UpdateCounter& update_calls() {
+            static UpdateCounter n {0};
+            return n;
+        }
+
+        // enter() / update() / exit() are called through these to be measured by the profiler and the trace
+        void call_enter() {
+            if (!(hooks & HOOK_ENTER)) return;
+#if defined(TASKMANAGER_PROFILER_ENABLE) || defined(TASKMANAGER_TRACE_ENABLE)
+            const uint32_t begin_us = micros();
+            this->enter();
+            const uint32_t us = micros() - begin_us;
+#ifdef TASKMANAGER_PROFILER_ENABLE
+            profile.addEnter(us);
+#endif
+#ifdef TASKMANAGER_TRACE_ENABLE
+            Trace::get().record(TraceEvent::ENTER, trace_id, begin_us, us);
+#endif
+#else
+            this->enter();
+#endif
+        }
+        void call_update() {
+            ++update_calls();
+#if defined(TASKMANAGER_PROFILER_ENABLE) || defined(TASKMANAGER_TRACE_ENABLE)
+#ifdef TASKMANAGER_PROFILER_ENABLE
+            const uint32_t late_us = getFrameLatenessUsec();
+#endif
+            const uint32_t begin_us = micros();
+            this->update();
+            const uint32_t us = micros() - begin_us;
+#ifdef TASKMANAGER_PROFILER_ENABLE
+            profile.addUpdate(us, late_us);
+#endif
+#ifdef TASKMANAGER_TRACE_ENABLE
+            Trace::get().record(TraceEvent::UPDATE, trace_id, begin_us, us);
+#endif
+#else
+            this->update();
+#endif
+        }
+        // FrameRateCounter::update() and update() with the overrun policy
+        void update_frame() {
+            const int64_t prev = (int64_t)frame();
+            if (!FrameRateCounter::update()) return;
+            const int64_t missed = (int64_t)frame() - prev - 1;
+            if (missed <= 0) {
+                call_update();
+                return;
+            }
+
+            int64_t catch_up = 0;
+            switch (overrun_policy) {
+                case OverrunPolicy::CATCH_UP: {
+                    catch_up = (missed < max_catch_up) ? missed : max_catch_up;
+                    break;
+                }
+                case OverrunPolicy::REPHASE: {
+                    // the current frame starts now, and the next one is one interval later
+                    const int64_t frame_us = (int64_t)ceil(frame() * getIntervalSec() * 1000000.);
+                    if (usec64() > frame_us) setTimeUsec64(frame_us);
+                    reschedule();
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+            add_saturated(missed_frames, missed);
+            add_saturated(coalesced_frames, missed - catch_up);
+
+            call_update();
+            // the task may be stopped in update()
+            for (int64_t i = 0; (i < catch_up) && isRunning(); ++i) call_update();
+        }
+        static void add_saturated(uint16_t& n, const int64_t k) {
+            n = (n + k < 0xFFFF) ? (uint16_t)(n + k) : 0xFFFF;
+        }
+
+        void call_exit() {
+            if (hooks & HOOK_EXIT) {
+#if defined(TASKMANAGER_PROFILER_ENABLE) || defined(TASKMANAGER_TRACE_ENABLE)
+                const uint32_t begin_us = micros();
+                this->exit();
+                const uint32_t us = micros() - begin_us;
+#ifdef TASKMANAGER_PROFILER_ENABLE
+                profile.addExit(us);
+#endif
+#ifdef TASKMANAGER_TRACE_ENABLE
+                Trace::get().record(TraceEvent::EXIT, trace_id, begin_us, us);
+#endif
+#else
+                this->exit();
+#endif
+            }
+#ifdef TASKMANAGER_HAS_COROUTINE
+            if (!stop_waiters.empty()) notify_stop_waiters();
+#endif
+        }
+
+#ifdef TASKMANAGER_HAS_COROUTINE
+        void notify_stop_waiters() {
+            const Lazy<Vec<Handle<Base>>> waiters = detail::move(stop_waiters);
+            for (const auto& h : waiters) {
+                Base* t = h.get();  // the coroutine may have been erased
+                if (t) t->notify();
+            }
+        }
+#endif
+
+#ifdef TASKMANAGER_PROFILER_ENABLE
+        // time [us] elapsed from the scheduled time of the current frame
+        uint32_t getFrameLatenessUsec() {
+            const double interval_us = getIntervalSec() * 1000000.;
+            if (interval_us <= 0.) return 0;  // every update()
+            const int64_t late = usec64() - frame_begin_usec64(frame(), interval_us);
+            if (late <= 0) return 0;
+            return (late < 0xFFFFFFFF) ? (uint32_t)late : 0xFFFFFFFF;
+        }
+#endif
+
+        // time [us] until this task (or one of its subtasks) should be updated next
+        // 0 means "now", -1 means "not until the task is controlled again"
+        int64_t getNextDueUsec64() {
+            if (!isRunning()) {
+                if (hasExit()) return 0;  // exit() is still pending
+                return -1;
+            }
+            if (hasEnter()) return 0;
+            if (b_event) return b_notified ? 0 : -1;  // with subtasks, only when notified
+
+            int64_t due = getFrameDueUsec64();
+            if (hasSubTasks()) due = earlier(due, getSubTaskDueUsec64());
+            return due;
+        }
+
+        // same as getNextDueUsec64() for the subtask which is updated by the parent (SYNC / SEQUENCE)
+        int64_t getDrivenDueUsec64() {
+            int64_t due = getFrameDueUsec64();
+            if (hasSubTasks() && isRunning()) due = earlier(due, getSubTaskDueUsec64());
+            return due;
+        }
+
+        int64_t getSubTaskDueUsec64() {
+            int64_t due = -1;
+            switch (getSubTaskMode()) {
+                case SubTaskMode::PARALLEL: {
+                    for (auto& st : subtasks) {
+                        if (st->isRunning() || st->hasExit())
+                            due = earlier(due, st->getNextDueUsec64());
+                        else if (st->hasIdleHook() || st->isAutoErase())
+                            due = 0;  // idle() every update() or erase it soon
+                    }
+                    break;
+                }
+                case SubTaskMode::SYNC: {
+                    for (auto& st : subtasks) due = earlier(due, st->getDrivenDueUsec64());
+                    break;
+                }
+                case SubTaskMode::SEQUENCE: {
+                    due = earlier(due, subtasks[getSubTaskIndex()]->getDrivenDueUsec64());
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+            return due;
+        }
+
+        // time [us] until FrameRateCounter::update() of this task returns true or its duration ends
+        int64_t getFrameDueUsec64() {
+            if (!isRunning()) return hasExit() ? 0 : -1;
+            const double interval_us = getIntervalSec() * 1000000.;
+            if (interval_us <= 0.) return 0;  // every update()
+
+            // time until the beginning of the next frame
+            const int64_t us = usec64();
+            int64_t due = frame_begin_usec64(floor((double)us / interval_us) + 1., interval_us) - us;
+            if (hasDuration()) {
+                const int64_t duration_us = (int64_t)(getDurationSec() * 1000000.);
+                due = earlier(due, (us < duration_us) ? (duration_us - us) : 0);
+            }
+            return due;
+        }
+
+        // time [us] of the beginning of frame n (in double not to accumulate the error of fractional intervals)
+        static int64_t frame_begin_usec64(const double n, const double interval_us) {
+            int64_t at = (int64_t)ceil(n * interval_us);
+            while (floor((double)at / interval_us) < n) ++at;  // count is floor(time / interval) in the counter
+            return at;
+        }
+
+        static int64_t earlier(const int64_t a, const int64_t b) {
+            if (a < 0) return b;
+            if (b < 0) return a;
+            return (a < b) ? a : b;
+        }
+
         void begin_recursive() {
             this->begin();
             for (auto& st : subtasks) {
@@ -269,7 +1359,7 @@ namespace task {
         }
 
         void enter_recursive() {
-            this->enter();
+            call_enter();
 
             int64_t us = usec64();
             switch (getSubTaskMode()) {
@@ -277,7 +1367,7 @@ namespace task {
                     for (auto& st : subtasks) {
                         st->startIntervalFromForSec(getIntervalSec(), getOffsetSec(), getDurationSec());
                         st->setTimeUsec64(us);
-                        st->enter();
+                        st->enter_recursive();
                     }
                     break;
                 }
@@ -292,69 +1382,193 @@ namespace task {
         }
 
         void update_recursive() {
+#ifdef TASKMANAGER_PROFILER_ENABLE
+            const uint32_t begin_us = micros();
+#endif
+            if (visit_node()) {
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+                if (build_tree())
+                    update_tree();
+                else
+                    update_subtasks_recursive();
+#else
+                update_subtasks_recursive();
+#endif
+            }
+            leave_node();
+#ifdef TASKMANAGER_PROFILER_ENABLE
+            profile.addRecursive(micros() - begin_us);
+#endif
+        }
+
+        // first half of the update of this task (before its subtasks)
+        // returns true if the subtasks should be updated
+        bool visit_node() {
+            const SubTaskMode role = parent ? parent->mode : SubTaskMode::PARALLEL;
+            if (role != SubTaskMode::PARALLEL) {
+                // SYNC and SEQUENCE subtasks are started, stopped and proceeded by the parent
+                update_frame();
+                return hasSubTasks() && isRunning();
+            }
+
+            // main task and PARALLEL subtasks
             if (isRunning()) {
                 if (hasEnter()) {
                     releaseEventTrigger();  // disable hasExit()
                     enter_recursive();
                 }
 
-                if (FrameRateCounter::update()) {
-                    this->update();
-                }
-
-                if (hasSubTasks()) {
-                    switch (getSubTaskMode()) {
-                        case SubTaskMode::PARALLEL: {
-                            // same procedure with main task
-                            // but its behavior is allowd only when the parent task is running
-                            auto it = subtasks.begin();
-                            while (it != subtasks.end()) {
-                                (*it)->update_recursive();
-                                if ((*it)->isStopping() && (*it)->isAutoErase()) {
-                                    it = subtasks.erase(it);
-                                } else {
-                                    ++it;
-                                }
-                            }
-                        }
-                        case SubTaskMode::SYNC: {
-                            // update all subtasks
-                            for (auto& st : subtasks) {
-                                if (st->FrameRateCounter::update()) {
-                                    st->update();
-                                }
-                            }
-                            break;
-                        }
-                        case SubTaskMode::SEQUENCE: {
-                            // update subtasks one by one
-                            const size_t idx = getSubTaskIndex();
-                            auto st = subtasks[idx];
-                            if (st->FrameRateCounter::update()) {
-                                st->update();
-                            }
-                            // for duration ends
-                            if (st->hasExit()) {
-                                st->releaseEventTrigger();  // disable hasExit()
-                                st->exit();
-                                if (idx + 1 < numSubTasks()) proceedToNextSubTask();
-                            }
-                            break;
-                        }
-                        default: {
-                            break;
-                        }
+                if (b_event) {
+                    if (b_notified) {
+                        b_notified = false;
+                        notify_count = num_notified;
+                        num_notified = 0;
+                        call_update();
                     }
+                } else {
+                    update_frame();
                 }
+                return hasSubTasks();
             } else {
                 idle_recursive();
+                return false;
             }
-            // for external trigger
-            if (hasExit()) {
-                releaseEventTrigger();  // disable hasExit()
-                exit_recursive();
+        }
+
+        // second half of the update of this task (after its subtasks)
+        void leave_node() {
+            // if auto erase is enabled, erase stopped PARALLEL subtasks
+            if (b_erase_pending) {
+                b_erase_pending = false;
+                SubTasks& sts = subtasks.get();
+                auto it = sts.begin();
+                while (it != sts.end()) {
+                    if ((*it)->isStopping() && (*it)->isAutoErase()) {
+                        it = erase_subtask(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            const SubTaskMode role = parent ? parent->mode : SubTaskMode::PARALLEL;
+            switch (role) {
+                case SubTaskMode::PARALLEL: {
+                    // for external trigger
+                    if (hasExit()) {
+                        releaseEventTrigger();  // disable hasExit()
+                        exit_recursive();
+                    }
+                    if (parent && isStopping() && isAutoErase()) parent->b_erase_pending = true;
+                    break;
+                }
+                case SubTaskMode::SEQUENCE: {
+                    // for duration ends
+                    if (hasExit()) {
+                        releaseEventTrigger();  // disable hasExit()
+                        exit_recursive();
+                        if ((size_t)parent->subtask_index + 1 < parent->numSubTasks()) parent->proceedToNextSubTask();
+                    }
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        }
+
+        // subtasks which should be updated in this frame (all, or the current one for SEQUENCE)
+        void update_subtasks_recursive() {
+            switch (getSubTaskMode()) {
+                case SubTaskMode::PARALLEL:
+                case SubTaskMode::SYNC: {
+                    for (size_t i = 0; i < subtasks.size(); ++i) subtasks[i]->update_node_recursive();
+                    break;
+                }
+                case SubTaskMode::SEQUENCE: {
+                    subtasks[getSubTaskIndex()]->update_node_recursive();
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        }
+
+        void update_node_recursive() {
+            if (visit_node()) update_subtasks_recursive();
+            leave_node();
+        }
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        // flatten the subtask tree in pre-order (only when the structure has been changed)
+        bool build_tree() {
+            if (b_tree_dirty) {
+                b_tree_dirty = false;
+                if (tree.allocated()) tree.get().clear();
+                if (!append_tree(this, TREE_ROOT)) {
+                    LOG_ERROR("Too many subtasks to flatten: update them recursively");
+                    tree.reset();
+                }
+            }
+            return !tree.empty();
+        }
+
+        bool append_tree(Base* t, const uint16_t parent_index) {
+            for (size_t k = 0; k < t->subtasks.size(); ++k) {
+                Tree& nodes = tree.get();
+                const size_t i = nodes.size();
+                if (i >= TREE_ROOT) return false;
+                nodes.emplace_back(TreeNode {t->subtasks[k], parent_index, 0, (uint16_t)k});
+                if (!append_tree(t->subtasks[k].get(), (uint16_t)i)) return false;
+                nodes[i].next = (uint16_t)nodes.size();
+            }
+            return true;
+        }
+
+        // the node is still the k-th subtask of its parent
+        // (the tree is rebuilt in the next update() if the structure is changed while it is updated)
+        bool is_attached(const TreeNode& node) const {
+            const Base* p = node.task->parent;
+            return p && (node.index < p->subtasks.size()) && (p->subtasks[node.index] == node.task);
+        }
+
+        // same procedure as update_subtasks_recursive() as a linear sweep of the flattened tree
+        // subtrees which are not updated (stopped or not the current SEQUENCE step) are skipped by tree[i].next
+        // (nodes are read by index because clear() in callbacks may release the tree)
+        void update_tree() {
+            size_t i = 0;
+            while (i < tree.size()) {
+                size_t end = tree[i].next;    // next node to be visited
+                size_t last = tree[i].parent;  // deepest node which may be left
+                if (is_attached(tree[i])) {
+                    Base* t = tree[i].task.get();
+                    if ((t->parent->mode != SubTaskMode::SEQUENCE) || (t->parent->subtask_index == tree[i].index)) {
+                        if (t->visit_node()) end = i + 1;
+                        last = i;
+                    }
+                }
+                // leave the nodes whose subtrees have been finished
+                while ((last < tree.size()) && (tree[last].next <= end)) {
+                    const uint16_t parent_index = tree[last].parent;
+                    if (is_attached(tree[last])) {
+                        Base* t = tree[last].task.get();
+                        const bool b_step = t->parent->mode == SubTaskMode::SEQUENCE;
+                        t->leave_node();
+                        // other steps are not updated in this frame even if the sequence proceeds
+                        if (b_step) {
+                            if (parent_index == TREE_ROOT)
+                                end = tree.size();
+                            else if ((parent_index < tree.size()) && (end < tree[parent_index].next))
+                                end = tree[parent_index].next;
+                        }
+                    }
+                    last = parent_index;
+                }
+                i = end;
             }
         }
+#endif
 
         void exit_recursive() {
             if (hasSubTasks()) {
@@ -364,14 +1578,15 @@ namespace task {
                             if (st->isRunning()) st->stop();
                             if (st->hasExit()) {
                                 st->releaseEventTrigger();  // disable hasExit()
-                                st->exit();
+                                st->exit_recursive();
                             }
                         }
                         // if auto erase is enabled, erase it
-                        auto it = subtasks.begin();
-                        while (it != subtasks.end()) {
+                        SubTasks& sts = subtasks.get();
+                        auto it = sts.begin();
+                        while (it != sts.end()) {
                             if ((*it)->isStopping() && (*it)->isAutoErase()) {
-                                it = subtasks.erase(it);
+                                it = erase_subtask(it);
                             } else {
                                 ++it;
                             }
@@ -383,20 +1598,24 @@ namespace task {
                             if (st->isRunning()) st->stop();
                             if (st->hasExit()) {
                                 st->releaseEventTrigger();  // disable hasExit()
-                                st->exit();
+                                st->exit_recursive();
                             }
                         }
                         break;
                     }
                     case SubTaskMode::SEQUENCE: {
                         // exit active subtask
-                        auto st = subtasks[getSubTaskIndex()];
-                        if (st->isRunning()) {
-                            st->stop();
+                        // (not found by subtask_index: stop() of this task has already reset it)
+                        b_timeline_lock = true;
+                        for (auto& st : subtasks) {
+                            if (st->isRunning()) st->stop();
                         }
-                        if (st->hasExit()) {
-                            st->releaseEventTrigger();  // disable hasExit()
-                            st->exit();
+                        b_timeline_lock = false;
+                        for (auto& st : subtasks) {
+                            if (st->hasExit()) {
+                                st->releaseEventTrigger();  // disable hasExit()
+                                st->exit_recursive();
+                            }
                         }
                         break;
                     }
@@ -406,15 +1625,25 @@ namespace task {
                 }
             }
             subtask_index = 0;
-            this->exit();
+            call_exit();
         }
 
         void idle_recursive() {
-            this->idle();
+            if (hooks & HOOK_IDLE) call_idle();
+            if (!b_subtask_idle_hook) return;
             for (auto& st : subtasks) {
-                st->idle();
+                if (st->hooks & HOOK_IDLE) st->call_idle();
             }
         }
+        void call_idle() {
+#ifdef TASKMANAGER_TRACE_ENABLE
+            const uint32_t begin_us = micros();
+            this->idle();
+            Trace::get().record(TraceEvent::IDLE, trace_id, begin_us, micros() - begin_us);
+#else
+            this->idle();
+#endif
+        }
 
         void reset_recursive() {
             for (auto& st : subtasks) {
@@ -427,17 +1656,22 @@ namespace task {
         bool startSubTask(const size_t idx) {
             if (idx < numSubTasks()) {
                 int64_t us = this->usec64();
-                subtask_index = idx;
+                subtask_index = (uint16_t)idx;
                 auto st = subtasks[idx];
                 double interval_sec = st->hasInterval() ? st->getIntervalSec() : getIntervalSec();
                 double offset_sec = st->hasOffset() ? st->getOffsetSec() : getOffsetSec();
                 double duration_sec = st->hasDuration() ? st->getDurationSec() : getDurationSec();
+                const bool b_had_duration = st->hasDuration();
+                const bool b_locked = b_timeline_lock;
+                b_timeline_lock = true;
                 st->startIntervalFromForSec(interval_sec, offset_sec, duration_sec);
+                b_timeline_lock = b_locked;
+                if (b_had_duration != st->hasDuration()) b_timeline_dirty = true;  // inherited from main task
 
                 // compensate the time difference of main task and sub tasks
-                if (hasFixedSubTaskDuration()) st->setTimeUsec64(us - getCurrentDurationSecSum() * 1000000);
+                if (hasFixedSubTaskDuration()) st->setTimeUsec64(us - timeline[idx]);
 
-                st->enter();
+                st->enter_recursive();
                 return true;
             } else {
                 LOG_ERROR("Couldn't run next subtask: index", idx, "should <", numSubTasks());
@@ -448,14 +1682,17 @@ namespace task {
         bool nextSubTaskImpl() {
             if (mode == SubTaskMode::SEQUENCE) {
                 auto st = subtasks[subtask_index];
+                const bool b_locked = b_timeline_lock;
+                b_timeline_lock = true;
                 if (st->isRunning()) {
                     st->stop();
                 }
+                b_timeline_lock = b_locked;
                 if (st->hasExit()) {
                     st->releaseEventTrigger();  // disable hasExit()
-                    st->exit();
+                    st->exit_recursive();
                 }
-                if (subtask_index + 1 < subtasks.size())
+                if ((size_t)subtask_index + 1 < subtasks.size())
                     return startSubTask(subtask_index + 1);
                 else {
                     LOG_WARN("No more subtasks : index", subtask_index, "size", numSubTasks());
@@ -476,10 +1713,38 @@ namespace task {
             }
         }
 
-        bool hasFixedSubTaskDuration() const {
-            for (const auto& st : subtasks)
-                if (!st->hasDuration()) return false;
-            return true;
+        // rebuild the start times of subtasks only when they may be changed
+        void update_timeline() {
+            if (!b_timeline_dirty) return;
+            b_timeline_dirty = false;
+            b_timeline_fixed = true;
+            Timeline& starts = timeline.get();
+            starts.clear();
+            int64_t sum = 0;
+            starts.emplace_back(sum);
+            for (const auto& st : subtasks) {
+                if (!st->hasDuration()) b_timeline_fixed = false;
+                sum += (int64_t)(st->getDurationSec() * 1000000.);
+                starts.emplace_back(sum);
+            }
+        }
+
+        // index of the subtask which is active at us (binary search of the start times)
+        size_t findSubTaskAt(const int64_t us) const {
+            size_t lo = 0, hi = numSubTasks();
+            while (hi - lo > 1) {
+                const size_t mid = lo + (hi - lo) / 2;
+                if (timeline[mid] <= us)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        bool hasFixedSubTaskDuration() {
+            update_timeline();
+            return b_timeline_fixed;
         }
 
         double getCurrentDurationSec() const {
@@ -489,13 +1754,9 @@ namespace task {
                 return 0.;
         }
 
-        double getCurrentDurationSecSum() const {
+        double getCurrentDurationSecSum() {
             if (mode == SubTaskMode::SEQUENCE) {
-                if (hasFixedSubTaskDuration()) {
-                    double d = 0.;
-                    for (size_t i = 0; i < subtask_index; ++i) d += subtasks[i]->getDurationSec();
-                    return d;
-                }
+                if (hasFixedSubTaskDuration()) return (double)timeline[subtask_index] * 0.000001;
             }
             return 0.;
         }
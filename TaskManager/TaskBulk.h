@@ -0,0 +1,326 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_BULK_H
+#define ARDUINO_TASK_MANAGER_TASK_BULK_H
+
+#include <Arduino.h>
+
+#include "TaskBase.h"
+
+namespace arduino {
+namespace task {
+
+    // Task method wrappers which are applied to a set of tasks (all tasks in Manager, members of Group).
+    // Derived class should have `template <typename F> void for_each_task(F& f)` which calls f(Base&).
+    template <typename Derived>
+    class BulkControl {
+    public:
+        void start() {
+            each([&](Base& t) { t.start(); });
+        }
+
+        void startFromSec(const double from_sec) {
+            each([&](Base& t) { t.startFromSec(from_sec); });
+        }
+        void startFromMsec(const double from_ms) {
+            each([&](Base& t) { t.startFromMsec(from_ms); });
+        }
+        void startFromUsec(const double from_us) {
+            each([&](Base& t) { t.startFromUsec(from_us); });
+        }
+
+        void startForSec(const double for_sec, const bool loop = false) {
+            each([&](Base& t) { t.startForSec(for_sec, loop); });
+        }
+        void startForMsec(const double for_ms, const bool loop = false) {
+            each([&](Base& t) { t.startForMsec(for_ms, loop); });
+        }
+        void startForUsec(const double for_us, const bool loop = false) {
+            each([&](Base& t) { t.startForUsec(for_us, loop); });
+        }
+
+        void startFromForSec(const double from_sec, const double for_sec, const bool loop = false) {
+            each([&](Base& t) { t.startFromForSec(from_sec, for_sec, loop); });
+        }
+        void startFromForMsec(const double from_ms, const double for_ms, const bool loop = false) {
+            each([&](Base& t) { t.startFromForMsec(from_ms, for_ms, loop); });
+        }
+        void startFromForUsec(const double from_us, const double for_us, const bool loop = false) {
+            each([&](Base& t) { t.startFromForUsec(from_us, for_us, loop); });
+        }
+        void startFromForUsec64(const int64_t from_us, const int64_t for_us, const bool loop = false) {
+            each([&](Base& t) { t.startFromForUsec64(from_us, for_us, loop); });
+        }
+
+        void startFromCount(const double from_count) {
+            each([&](Base& t) { t.startFromCount(from_count); });
+        }
+        void startForCount(const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startForCount(for_count, loop); });
+        }
+        void startFromForCount(const double from_count, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startFromForCount(from_count, for_count, loop); });
+        }
+
+        void startIntervalSec(const double interval_sec) {
+            each([&](Base& t) { t.startIntervalSec(interval_sec); });
+        }
+        void startIntervalMsec(const double interval_ms) {
+            each([&](Base& t) { t.startIntervalMsec(interval_ms); });
+        }
+        void startIntervalUsec(const double interval_us) {
+            each([&](Base& t) { t.startIntervalUsec(interval_us); });
+        }
+
+        void startIntervalFromSec(const double interval_sec, const double from_sec) {
+            each([&](Base& t) { t.startIntervalFromSec(interval_sec, from_sec); });
+        }
+        void startIntervalFromMsec(const double interval_ms, const double from_ms) {
+            each([&](Base& t) { t.startIntervalFromMsec(interval_ms, from_ms); });
+        }
+        void startIntervalFromUsec(const double interval_us, const double from_us) {
+            each([&](Base& t) { t.startIntervalFromUsec(interval_us, from_us); });
+        }
+        void startIntervalSecFromCount(const double interval_sec, const double from_count) {
+            each([&](Base& t) { t.startIntervalSecFromCount(interval_sec, from_count); });
+        }
+        void startIntervalMsecFromCount(const double interval_ms, const double from_count) {
+            each([&](Base& t) { t.startIntervalMsecFromCount(interval_ms, from_count); });
+        }
+        void startIntervalUsecFromCount(const double interval_us, const double from_count) {
+            each([&](Base& t) { t.startIntervalUsecFromCount(interval_us, from_count); });
+        }
+
+        void startIntervalForSec(const double interval_sec, const double for_sec, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalForSec(interval_sec, for_sec, loop); });
+        }
+        void startIntervalForMsec(const double interval_ms, const double for_ms, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalForMsec(interval_ms, for_ms, loop); });
+        }
+        void startIntervalForUsec(const double interval_us, const double for_us, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalForUsec(interval_us, for_us, loop); });
+        }
+        void startIntervalSecForCount(const double interval_sec, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalSecForCount(interval_sec, for_count, loop); });
+        }
+        void startIntervalMsecForCount(const double interval_ms, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalMsecForCount(interval_ms, for_count, loop); });
+        }
+        void startIntervalUsecForCount(const double interval_us, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalUsecForCount(interval_us, for_count, loop); });
+        }
+
+        void startIntervalFromForSec(
+            const double interval_sec, const double from_sec, const double for_sec, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalFromForSec(interval_sec, from_sec, for_sec, loop); });
+        }
+        void startIntervalFromForMsec(
+            const double interval_ms, const double from_ms, const double for_ms, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalFromForMsec(interval_ms, from_ms, for_ms, loop); });
+        }
+        void startIntervalFromForUsec(
+            const double interval_us, const double from_us, const double for_us, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalFromForUsec(interval_us, from_us, for_us, loop); });
+        }
+        void startIntervalSecFromForCount(
+            const double interval_sec, const double from_count, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalSecFromForCount(interval_sec, from_count, for_count, loop); });
+        }
+        void startIntervalMsecFromForCount(
+            const double interval_ms, const double from_count, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalMsecFromForCount(interval_ms, from_count, for_count, loop); });
+        }
+        void startIntervalUsecFromForCount(
+            const double interval_us, const double from_count, const double for_count, const bool loop = false) {
+            each([&](Base& t) { t.startIntervalUsecFromForCount(interval_us, from_count, for_count, loop); });
+        }
+
+        void startFromFrame(const double from_frame) {
+            each([&](Base& t) { t.startFromFrame(from_frame); });
+        }
+
+        void startForFrame(const double for_frame, const bool loop = false) {
+            each([&](Base& t) { t.startForFrame(for_frame, loop); });
+        }
+
+        void startFromForFrame(const double from_frame, const double for_frame, const bool loop = false) {
+            each([&](Base& t) { t.startFromForFrame(from_frame, for_frame, loop); });
+        }
+
+        void startFps(const double fps) {
+            each([&](Base& t) { t.startFps(fps); });
+        }
+
+        void startFpsFromSec(const double fps, const double from_sec) {
+            each([&](Base& t) { t.startFpsFromSec(fps, from_sec); });
+        }
+        void startFpsFromMsec(const double fps, const double from_ms) {
+            each([&](Base& t) { t.startFpsFromMsec(fps, from_ms); });
+        }
+        void startFpsFromUsec(const double fps, const double from_us) {
+            each([&](Base& t) { t.startFpsFromUsec(fps, from_us); });
+        }
+        void startFpsFromFrame(const double fps, const double from_frame) {
+            each([&](Base& t) { t.startFpsFromFrame(fps, from_frame); });
+        }
+
+        void startFpsForSec(const double fps, const double for_sec, const bool loop = false) {
+            each([&](Base& t) { t.startFpsForSec(fps, for_sec, loop); });
+        }
+        void startFpsForMsec(const double fps, const double for_ms, const bool loop = false) {
+            each([&](Base& t) { t.startFpsForMsec(fps, for_ms, loop); });
+        }
+        void startFpsForUsec(const double fps, const double for_us, const bool loop = false) {
+            each([&](Base& t) { t.startFpsForUsec(fps, for_us, loop); });
+        }
+        void startFpsForFrame(const double fps, const double for_frame, const bool loop = false) {
+            each([&](Base& t) { t.startFpsForFrame(fps, for_frame, loop); });
+        }
+
+        void startFpsFromForSec(
+            const double fps, const double from_sec, const double for_sec, const bool loop = false) {
+            each([&](Base& t) { t.startFpsFromForSec(fps, from_sec, for_sec, loop); });
+        }
+        void startFpsFromForMsec(
+            const double fps, const double from_ms, const double for_ms, const bool loop = false) {
+            each([&](Base& t) { t.startFpsFromForMsec(fps, from_ms, for_ms, loop); });
+        }
+        void startFpsFromForUsec(
+            const double fps, const double from_us, const double for_us, const bool loop = false) {
+            each([&](Base& t) { t.startFpsFromForUsec(fps, from_us, for_us, loop); });
+        }
+        void startFpsFromForFrame(
+            const double fps, const double from_frame, const double for_frame, const bool loop = false) {
+            each([&](Base& t) { t.startFpsFromForFrame(fps, from_frame, for_frame, loop); });
+        }
+
+        void startOnce() {
+            each([&](Base& t) { t.startOnce(); });
+        }
+        void startOnceAfterSec(const double after_sec) {
+            each([&](Base& t) { t.startOnceAfterSec(after_sec); });
+        }
+        void startOnceAfterMsec(const double after_ms) {
+            each([&](Base& t) { t.startOnceAfterMsec(after_ms); });
+        }
+        void startOnceAfterUsec(const double after_us) {
+            each([&](Base& t) { t.startOnceAfterUsec(after_us); });
+        }
+
+        void stop() {
+            each([&](Base& t) { t.stop(); });
+        }
+
+        void play() {
+            each([&](Base& t) { t.play(); });
+        }
+
+        void pause() {
+            each([&](Base& t) { t.pause(); });
+        }
+
+        void restart() {
+            each([&](Base& t) { t.restart(); });
+        }
+
+        void setOffsetSec(const double sec) {
+            each([&](Base& t) { t.setOffsetSec(sec); });
+        }
+        void setOffsetMsec(const double ms) {
+            each([&](Base& t) { t.setOffsetMsec(ms); });
+        }
+        void setOffsetUsec(const double us) {
+            each([&](Base& t) { t.setOffsetUsec(us); });
+        }
+        void setOffsetUsec64(const int64_t us) {
+            each([&](Base& t) { t.setOffsetUsec64(us); });
+        }
+
+        void addOffsetSec(const double sec) {
+            each([&](Base& t) { t.addOffsetSec(sec); });
+        }
+        void addOffsetMsec(const double ms) {
+            each([&](Base& t) { t.addOffsetMsec(ms); });
+        }
+        void addOffsetUsec(const double us) {
+            each([&](Base& t) { t.addOffsetUsec(us); });
+        }
+        void addOffsetUsec64(const int64_t us) {
+            each([&](Base& t) { t.addOffsetUsec64(us); });
+        }
+
+        void setDurationSec(const double sec) {
+            each([&](Base& t) { t.setDurationSec(sec); });
+        }
+        void setDurationMsec(const double ms) {
+            each([&](Base& t) { t.setDurationMsec(ms); });
+        }
+        void setDurationUsec(const double us) {
+            each([&](Base& t) { t.setDurationUsec(us); });
+        }
+        void setDurationUsec64(const int64_t us) {
+            each([&](Base& t) { t.setDurationUsec64(us); });
+        }
+
+        void setTimeSec(const double sec) {
+            each([&](Base& t) { t.setTimeSec(sec); });
+        }
+        void setTimeMsec(const double ms) {
+            each([&](Base& t) { t.setTimeMsec(ms); });
+        }
+        void setTimeUsec(const double us) {
+            each([&](Base& t) { t.setTimeUsec(us); });
+        }
+        void setTimeUsec64(const int64_t us) {
+            each([&](Base& t) { t.setTimeUsec64(us); });
+        }
+
+        void setLoop(const bool b) {
+            each([&](Base& t) { t.setLoop(b); });
+        }
+
+        void setIntervalSec(const double sec) {
+            each([&](Base& t) { t.setIntervalSec(sec); });
+        }
+        void setIntervalMsec(const double ms) {
+            each([&](Base& t) { t.setIntervalMsec(ms); });
+        }
+        void setIntervalUsec(const double us) {
+            each([&](Base& t) { t.setIntervalUsec(us); });
+        }
+        void setIntervalUsec64(const int64_t us) {
+            each([&](Base& t) { t.setIntervalUsec64(us); });
+        }
+
+        void setOffsetCount(const double count) {
+            each([&](Base& t) { t.setOffsetCount(count); });
+        }
+
+        void setOffsetFrame(const double frame) {
+            each([&](Base& t) { t.setOffsetFrame(frame); });
+        }
+
+        void setFrameRate(const float fps) {
+            each([&](Base& t) { t.setFrameRate(fps); });
+        }
+
+        void setAutoErase(const bool b) {
+            each([&](Base& t) { t.setAutoErase(b); });
+        }
+        void setOverrunPolicy(const OverrunPolicy p, const uint8_t max_catch_up = 0xFF) {
+            each([&](Base& t) { t.setOverrunPolicy(p, max_catch_up); });
+        }
+        void setAdaptiveFps(const float preferred_fps, const float min_fps) {
+            each([&](Base& t) { t.setAdaptiveFps(preferred_fps, min_fps); });
+        }
+
+    private:
+        template <typename F>
+        void each(F&& f) {
+            static_cast<Derived*>(this)->for_each_task(f);
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_BULK_H
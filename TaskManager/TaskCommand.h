@@ -0,0 +1,216 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_COMMAND_H
+#define ARDUINO_TASK_MANAGER_TASK_COMMAND_H
+
+#include <Arduino.h>
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <atomic>
+#endif
+
+#ifndef TASKMANAGER_COMMAND_QUEUE_SIZE
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#define TASKMANAGER_COMMAND_QUEUE_SIZE 16
+#else
+#define TASKMANAGER_COMMAND_QUEUE_SIZE 4
+#endif
+#endif  // TASKMANAGER_COMMAND_QUEUE_SIZE
+
+namespace arduino {
+namespace task {
+
+    // Task control which can be posted from interrupts and other threads by Manager::post().
+    // It is applied to the task at the beginning of the next Manager::update().
+    struct Command {
+        enum class Type : uint8_t {
+            START,
+            STOP,
+            PLAY,
+            PAUSE,
+            RESTART,
+            START_FPS,
+            START_INTERVAL_USEC,
+            RESET,
+            NOTIFY,
+            ERASE,
+            CALL,  // call fn(arg) inside of update() (e.g. to add tasks)
+        };
+
+        Type type;
+        union {
+            double value;  // START_FPS, START_INTERVAL_USEC
+            struct {
+                void (*fn)(void*);
+                void* arg;
+            } callback;  // CALL
+        };
+
+        static Command start() {
+            return make(Type::START);
+        }
+        static Command stop() {
+            return make(Type::STOP);
+        }
+        static Command play() {
+            return make(Type::PLAY);
+        }
+        static Command pause() {
+            return make(Type::PAUSE);
+        }
+        static Command restart() {
+            return make(Type::RESTART);
+        }
+        static Command startFps(const double fps) {
+            return make(Type::START_FPS, fps);
+        }
+        static Command startIntervalUsec(const double interval_us) {
+            return make(Type::START_INTERVAL_USEC, interval_us);
+        }
+        static Command reset() {
+            return make(Type::RESET);
+        }
+        static Command notify() {
+            return make(Type::NOTIFY);
+        }
+        static Command erase() {
+            return make(Type::ERASE);
+        }
+        static Command call(void (*fn)(void*), void* arg = nullptr) {
+            Command c = make(Type::CALL);
+            c.callback.fn = fn;
+            c.callback.arg = arg;
+            return c;
+        }
+
+    private:
+        static Command make(const Type type, const double value = 0.) {
+            Command c;
+            c.type = type;
+            c.value = value;
+            return c;
+        }
+    };
+
+    // Bounded multi-producer / single-consumer ring of preallocated entries.
+    // push() can be called from interrupts and any threads, pop() only from the thread which calls update().
+    // With libstdc++, it is lock-free (each entry has a sequence number, producers claim entries by CAS).
+    // Otherwise (e.g. AVR) the ring is guarded by disabling interrupts.
+    template <typename T, size_t N>
+    class CommandQueue {
+        static_assert((N >= 2) && ((N & (N - 1)) == 0), "TASKMANAGER_COMMAND_QUEUE_SIZE should be power of 2");
+        static constexpr size_t MASK = N - 1;
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        struct Entry {
+            std::atomic<size_t> seq;
+            T data;
+        };
+
+        Entry entries[N];
+        std::atomic<size_t> head {0};  // next position to push
+        size_t tail {0};               // next position to pop
+        std::atomic<uint32_t> num_overflows {0};
+
+    public:
+        CommandQueue() {
+            for (size_t i = 0; i < N; ++i) entries[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        bool push(const T& data) {
+            size_t pos = head.load(std::memory_order_relaxed);
+            Entry* e = nullptr;
+            while (true) {
+                e = &entries[pos & MASK];
+                const size_t seq = e->seq.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    num_overflows.fetch_add(1, std::memory_order_relaxed);
+                    return false;  // full
+                } else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+            e->data = data;
+            e->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T& data) {
+            Entry& e = entries[tail & MASK];
+            const size_t seq = e.seq.load(std::memory_order_acquire);
+            if ((intptr_t)seq - (intptr_t)(tail + 1) < 0) return false;  // empty (or not written yet)
+            data = e.data;
+            e.seq.store(tail + N, std::memory_order_release);
+            ++tail;
+            return true;
+        }
+
+        uint32_t overflows() const {
+            return num_overflows.load(std::memory_order_relaxed);
+        }
+        void resetOverflows() {
+            num_overflows.store(0, std::memory_order_relaxed);
+        }
+#else
+        T entries[N];
+        volatile size_t head {0};
+        volatile size_t tail {0};
+        volatile uint32_t num_overflows {0};
+
+        // keeps the interrupt state of the caller (push() may be called inside of ISR)
+        struct CriticalSection {
+#ifdef __AVR__
+            uint8_t sreg;
+            CriticalSection() : sreg(SREG) {
+                cli();
+            }
+            ~CriticalSection() {
+                SREG = sreg;
+            }
+#else
+            CriticalSection() {
+                noInterrupts();
+            }
+            ~CriticalSection() {
+                interrupts();
+            }
+#endif
+        };
+
+    public:
+        bool push(const T& data) {
+            CriticalSection cs;
+            if (head - tail >= N) {
+                num_overflows = num_overflows + 1;
+                return false;  // full
+            }
+            entries[head & MASK] = data;
+            head = head + 1;
+            return true;
+        }
+
+        bool pop(T& data) {
+            CriticalSection cs;
+            if (head == tail) return false;
+            data = entries[tail & MASK];
+            tail = tail + 1;
+            return true;
+        }
+
+        uint32_t overflows() const {
+            CriticalSection cs;
+            return num_overflows;
+        }
+        void resetOverflows() {
+            CriticalSection cs;
+            num_overflows = 0;
+        }
+#endif
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_COMMAND_H
@@ -0,0 +1,202 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_COROUTINE_H
+#define ARDUINO_TASK_MANAGER_TASK_COROUTINE_H
+
+#include "TaskBase.h"
+
+#ifdef TASKMANAGER_HAS_COROUTINE
+
+#include <coroutine>
+#include <exception>
+
+#include "TaskPool.h"
+
+#ifndef TASKMANAGER_COROUTINE_POOL_SIZE
+#define TASKMANAGER_COROUTINE_POOL_SIZE 2048
+#endif  // TASKMANAGER_COROUTINE_POOL_SIZE
+
+namespace arduino {
+namespace task {
+
+    class CoroutineTask;
+
+    // arena for coroutine frames (spawn() doesn't allocate frames from the heap until it is exhausted)
+    using CoroutinePool = BasicPool<TASKMANAGER_COROUTINE_POOL_SIZE, struct CoroutinePoolTag>;
+
+    // return type of the coroutine which is run by Manager::spawn()
+    class Coroutine {
+    public:
+        struct promise_type {
+            CoroutineTask* task {nullptr};  // the task which resumes this coroutine
+
+            Coroutine get_return_object() {
+                return Coroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept {
+                return {};  // started by the first update() of the task
+            }
+            std::suspend_always final_suspend() noexcept {
+                return {};  // destroyed by the task
+            }
+            void return_void() {}
+            void unhandled_exception() {
+                std::terminate();
+            }
+
+            static void* operator new(const size_t n) {
+                return CoroutinePool::allocate(n);
+            }
+            static void operator delete(void* p, const size_t n) {
+                CoroutinePool::deallocate(p, n);
+            }
+        };
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        explicit Coroutine(const handle_type h) : coro(h) {}
+        Coroutine(Coroutine&& c) noexcept : coro(c.coro) {
+            c.coro = nullptr;
+        }
+        Coroutine& operator=(Coroutine&& c) noexcept {
+            if (this != &c) {
+                if (coro) coro.destroy();
+                coro = c.coro;
+                c.coro = nullptr;
+            }
+            return *this;
+        }
+        Coroutine(const Coroutine&) = delete;
+        Coroutine& operator=(const Coroutine&) = delete;
+        ~Coroutine() {
+            if (coro) coro.destroy();
+        }
+
+        // pass the ownership of the frame to the task
+        handle_type release() {
+            handle_type h = coro;
+            coro = nullptr;
+            return h;
+        }
+
+    private:
+        handle_type coro;
+    };
+
+    // task which resumes the coroutine, its schedule is changed by the awaiters below
+    // it stops (and is erased by auto erase) when the coroutine returns
+    class CoroutineTask : public Base {
+        friend class Manager;
+        friend class StopAwaiter;
+
+        Coroutine::handle_type coro;
+        Handle<Base> self;  // set by Manager::spawn()
+        uint32_t wake_us {0};
+        bool b_sleeping {false};
+
+    public:
+        CoroutineTask(const String& name, Coroutine&& c) : Base(name), coro(c.release()) {
+            if (coro) coro.promise().task = this;
+        }
+        virtual ~CoroutineTask() {
+            if (coro) coro.destroy();
+        }
+        CoroutineTask(const CoroutineTask&) = delete;
+        CoroutineTask& operator=(const CoroutineTask&) = delete;
+
+        virtual void update() override {
+            if (!coro || coro.done()) return;
+            if (b_sleeping) {
+                const int32_t remaining_us = (int32_t)(wake_us - (uint32_t)micros());
+                if (remaining_us > 0) {
+                    startIntervalUsec((double)remaining_us);  // woken too early
+                    return;
+                }
+                b_sleeping = false;
+            }
+            coro.resume();
+            if (coro.done()) stop();
+        }
+
+        // resume the coroutine in the next update()
+        void wake() {
+            b_sleeping = false;
+            startOnEvent();
+            notify();
+        }
+        // resume the coroutine after us
+        void sleep(const uint32_t us) {
+            wake_us = (uint32_t)micros() + us;
+            b_sleeping = true;
+            startIntervalUsec((double)us);
+        }
+        // resume the coroutine by notify()
+        void suspend() {
+            b_sleeping = false;
+            startOnEvent();
+        }
+
+        bool isDone() const {
+            return !coro || coro.done();
+        }
+    };
+
+    // co_await sleepUsec(us): resume after us (0: in the next update())
+    class SleepAwaiter {
+        uint32_t us;
+
+    public:
+        explicit SleepAwaiter(const uint32_t us) : us(us) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(const Coroutine::handle_type h) const {
+            CoroutineTask* t = h.promise().task;
+            if (us == 0)
+                t->wake();
+            else
+                t->sleep(us);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    inline SleepAwaiter sleepUsec(const uint32_t us) {
+        return SleepAwaiter(us);
+    }
+    inline SleepAwaiter sleepMs(const uint32_t ms) {
+        return SleepAwaiter(ms * 1000UL);
+    }
+    inline SleepAwaiter sleepSec(const double sec) {
+        return SleepAwaiter((uint32_t)(sec * 1000000.));
+    }
+    inline SleepAwaiter nextFrame() {
+        return SleepAwaiter(0);
+    }
+
+    // co_await task->stopped(): resume after the task exits (or is erased)
+    class StopAwaiter {
+        Base* target;
+
+    public:
+        explicit StopAwaiter(Base* target) : target(target) {}
+
+        bool await_ready() const {
+            return !target || (!target->isRunning() && !target->hasExit());
+        }
+        void await_suspend(const Coroutine::handle_type h) const {
+            CoroutineTask* t = h.promise().task;
+            t->suspend();
+            target->stop_waiters.get().emplace_back(t->self);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    inline StopAwaiter Base::stopped() {
+        return StopAwaiter(this);
+    }
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // TASKMANAGER_HAS_COROUTINE
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_COROUTINE_H
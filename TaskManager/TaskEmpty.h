@@ -3,12 +3,23 @@
 #define ARDUINO_TASK_MANAGER_TASK_EMPTY_H
 
 #include "TaskBase.h"
+#include "TaskFunction.h"
 
 namespace arduino {
 namespace task {
 
     class TaskEmpty : public Base {
-        std::function<void(Base*)> func;
+        InplaceFunction<void(Base*)> func;
+
+        template <typename F>
+        void set_update_func(F&& f, detail::bool_tag<true>) {
+            func.assign(detail::forward<F>(f));
+        }
+        template <typename F>
+        void set_update_func(F&& f, detail::bool_tag<false>) {
+            using Fn = typename detail::decay_func<F>::type;
+            func.template emplace<detail::IgnoreTaskPtr<Fn>>(detail::forward<F>(f));
+        }
 
     public:
         TaskEmpty(const String& name) : Base(name) {}
@@ -17,8 +28,10 @@ namespace task {
             if (func) func(this);
         }
 
-        void add_update_func(const std::function<void(Base*)> f) {
-            func = f;
+        // accepts void() and void(Base*) callables
+        template <typename F>
+        void add_update_func(F&& f) {
+            set_update_func(detail::forward<F>(f), detail::bool_tag<detail::is_task_func<F>::takes_task>());
         }
     };
 
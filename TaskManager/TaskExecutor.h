@@ -0,0 +1,195 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_EXECUTOR_H
+#define ARDUINO_TASK_MANAGER_TASK_EXECUTOR_H
+
+#include <Arduino.h>
+
+#ifdef TASKMANAGER_EXECUTOR_ENABLE
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(ESP_PLATFORM)
+#include <esp_pthread.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#else
+#error "TASKMANAGER_EXECUTOR_ENABLE requires libstdc++ (std::thread)"
+#endif
+
+namespace arduino {
+namespace task {
+
+    // Work-stealing thread pool which runs the jobs of one tick and returns when all of them are done.
+    // Each worker owns a deque: it pops its own jobs from the back and steals others' from the front.
+    // Jobs pinned to a worker (affinity >= 0) are never stolen.
+    // Worker i is bound to CPU core (i % number of cores) on ESP32 and Linux.
+    class Executor {
+        struct Queue {
+            std::mutex mtx;
+            std::deque<size_t> shared;  // can be stolen by other workers
+            std::deque<size_t> pinned;  // only for this worker
+        };
+
+        std::vector<std::thread> threads;
+        std::unique_ptr<Queue[]> queues;
+        size_t num_workers {0};
+
+        std::mutex mtx;
+        std::condition_variable cv_start;
+        std::condition_variable cv_done;
+        uint32_t epoch {0};
+        bool b_stop {false};
+        std::atomic<size_t> remaining {0};
+        std::atomic<size_t> num_stolen {0};
+        std::function<void(size_t)> job;
+
+    public:
+        explicit Executor(const size_t workers) : queues(new Queue[workers]), num_workers(workers) {
+            threads.reserve(workers);
+            for (size_t i = 0; i < workers; ++i) {
+#if defined(ESP_PLATFORM)
+                esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+                cfg.pin_to_core = (int)(i % portNUM_PROCESSORS);
+                esp_pthread_set_cfg(&cfg);
+#endif
+                threads.emplace_back(&Executor::worker, this, i);
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+                const unsigned int cores = std::thread::hardware_concurrency();
+                if (cores > 1) {
+                    cpu_set_t cpus;
+                    CPU_ZERO(&cpus);
+                    CPU_SET(i % cores, &cpus);
+                    pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpu_set_t), &cpus);
+                }
+#endif
+            }
+        }
+
+        ~Executor() {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                b_stop = true;
+            }
+            cv_start.notify_all();
+            for (auto& t : threads) t.join();
+        }
+
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        size_t size() const {
+            return num_workers;
+        }
+
+        // number of jobs run by a worker other than the one they were queued to
+        size_t stolen() const {
+            return num_stolen.load();
+        }
+
+        // run fn(i) for all i in [0, n) and wait for all of them (barrier)
+        // affinity(i) < 0: any worker, otherwise pinned to worker (affinity(i) % size())
+        // the calling thread also runs jobs which are not pinned
+        template <typename Fn, typename AffinityFn>
+        void run(const size_t n, const Fn& fn, const AffinityFn& affinity) {
+            if (n == 0) return;
+            job = fn;
+            remaining = n;
+            size_t next = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const int a = affinity(i);
+                if (a >= 0) {
+                    Queue& q = queues[(size_t)a % num_workers];
+                    std::lock_guard<std::mutex> lock(q.mtx);
+                    q.pinned.push_back(i);
+                } else {
+                    Queue& q = queues[next];
+                    std::lock_guard<std::mutex> lock(q.mtx);
+                    q.shared.push_back(i);
+                    next = (next + 1) % num_workers;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                ++epoch;
+            }
+            cv_start.notify_all();
+
+            // help workers, then wait for the jobs still running
+            size_t i = 0;
+            while (steal(num_workers, i)) finish(i);
+            std::unique_lock<std::mutex> lock(mtx);
+            cv_done.wait(lock, [&] { return remaining.load() == 0; });
+        }
+
+    private:
+        void worker(const size_t id) {
+            uint32_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv_start.wait(lock, [&] { return b_stop || (epoch != seen); });
+                    if (b_stop) return;
+                    seen = epoch;
+                }
+                size_t i = 0;
+                while (pop(id, i) || steal(id, i)) finish(i);
+            }
+        }
+
+        void finish(const size_t i) {
+            job(i);
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mtx);
+                cv_done.notify_all();
+            }
+        }
+
+        bool pop(const size_t id, size_t& i) {
+            Queue& q = queues[id];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.pinned.empty()) {
+                i = q.pinned.back();
+                q.pinned.pop_back();
+                return true;
+            }
+            if (!q.shared.empty()) {
+                i = q.shared.back();
+                q.shared.pop_back();
+                return true;
+            }
+            return false;
+        }
+
+        // id == size() means the calling (main) thread
+        bool steal(const size_t id, size_t& i) {
+            for (size_t k = 1; k <= num_workers; ++k) {
+                const size_t victim = (id + k) % num_workers;
+                if (victim == id) continue;
+                Queue& q = queues[victim];
+                std::lock_guard<std::mutex> lock(q.mtx);
+                if (!q.shared.empty()) {
+                    i = q.shared.front();
+                    q.shared.pop_front();
+                    ++num_stolen;
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // TASKMANAGER_EXECUTOR_ENABLE
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_EXECUTOR_H
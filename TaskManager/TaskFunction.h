@@ -0,0 +1,151 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_FUNCTION_H
+#define ARDUINO_TASK_MANAGER_TASK_FUNCTION_H
+
+#include <Arduino.h>
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <new>
+#endif
+
+#include "TaskTraits.h"
+
+#ifndef TASKMANAGER_FUNCTION_CAPACITY
+#define TASKMANAGER_FUNCTION_CAPACITY (4 * sizeof(void*))
+#endif  // TASKMANAGER_FUNCTION_CAPACITY
+
+namespace arduino {
+namespace task {
+
+    class Base;
+
+    namespace detail {
+        struct yes {
+            char c[1];
+        };
+        struct no {
+            char c[2];
+        };
+
+        // task callbacks can be void() or void(Base*)
+        template <typename F>
+        struct is_task_func {
+            template <typename U>
+            static yes test_void(decltype(detail::declval<U&>()())*);
+            template <typename U>
+            static no test_void(...);
+            template <typename U>
+            static yes test_task(decltype(detail::declval<U&>()(static_cast<Base*>(nullptr)))*);
+            template <typename U>
+            static no test_task(...);
+
+            using Fn = typename decay_func<F>::type;
+            static constexpr bool takes_void = sizeof(test_void<Fn>(nullptr)) == sizeof(yes);
+            static constexpr bool takes_task = sizeof(test_task<Fn>(nullptr)) == sizeof(yes);
+            static constexpr bool value = takes_void || takes_task;
+        };
+
+        // adapts void() callable to void(Base*)
+        template <typename Fn>
+        struct IgnoreTaskPtr {
+            Fn f;
+            template <typename F>
+            explicit IgnoreTaskPtr(F&& f) : f(detail::forward<F>(f)) {}
+            void operator()(Base*) {
+                f();
+            }
+        };
+    }  // namespace detail
+
+    // std::function-like callable which stores the closure inside of itself (never allocates)
+    // closure larger than Capacity is a compile error
+    template <typename Signature, size_t Capacity = TASKMANAGER_FUNCTION_CAPACITY>
+    class InplaceFunction;
+
+    template <typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity> {
+        union Storage {
+            void* p;
+            long long ll;
+            double d;
+            unsigned char bytes[Capacity];
+        };
+
+        mutable Storage storage;
+        R (*invoker)(Storage&, Args...) {nullptr};
+        void (*mover)(Storage* dst, Storage& src) {nullptr};  // move to dst (if not nullptr) and destroy src
+
+        template <typename Fn>
+        static R invoke(Storage& s, Args... args) {
+            return (*reinterpret_cast<Fn*>(&s))(detail::forward<Args>(args)...);
+        }
+
+        template <typename Fn>
+        static void move_or_destroy(Storage* dst, Storage& src) {
+            Fn* f = reinterpret_cast<Fn*>(&src);
+            if (dst) new (dst) Fn(detail::move(*f));
+            f->~Fn();
+        }
+
+    public:
+        InplaceFunction() {}
+        InplaceFunction(const InplaceFunction&) = delete;
+        InplaceFunction& operator=(const InplaceFunction&) = delete;
+        InplaceFunction(InplaceFunction&& f) {
+            *this = detail::move(f);
+        }
+        InplaceFunction& operator=(InplaceFunction&& f) {
+            if (this != &f) {
+                reset();
+                if (f.mover) {
+                    f.mover(&storage, f.storage);
+                    invoker = f.invoker;
+                    mover = f.mover;
+                    f.invoker = nullptr;
+                    f.mover = nullptr;
+                }
+            }
+            return *this;
+        }
+        ~InplaceFunction() {
+            reset();
+        }
+
+        template <typename F>
+        void assign(F&& f) {
+            emplace<typename detail::decay_func<F>::type>(detail::forward<F>(f));
+        }
+
+        // construct the callable of type Fn directly inside of the storage
+        template <typename Fn, typename... CtorArgs>
+        void emplace(CtorArgs&&... args) {
+            static_assert(sizeof(Fn) <= Capacity, "Callable is too large: increase TASKMANAGER_FUNCTION_CAPACITY");
+            static_assert(alignof(Fn) <= alignof(Storage), "Callable is over-aligned for InplaceFunction");
+            reset();
+            new (&storage) Fn(detail::forward<CtorArgs>(args)...);
+            invoker = &invoke<Fn>;
+            mover = &move_or_destroy<Fn>;
+        }
+
+        void reset() {
+            if (mover) mover(nullptr, storage);
+            invoker = nullptr;
+            mover = nullptr;
+        }
+
+        explicit operator bool() const {
+            return invoker != nullptr;
+        }
+
+        R operator()(Args... args) const {
+            return invoker(storage, detail::forward<Args>(args)...);
+        }
+
+        static constexpr size_t capacity() {
+            return Capacity;
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_FUNCTION_H
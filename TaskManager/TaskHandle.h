@@ -0,0 +1,78 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_HANDLE_H
+#define ARDUINO_TASK_MANAGER_TASK_HANDLE_H
+
+#include <Arduino.h>
+
+namespace arduino {
+namespace task {
+
+    class Base;
+
+    namespace detail {
+        // defined in TaskManager.h
+        Base* resolve_handle(const uint16_t slot, const uint16_t generation);
+        Ref<Base> resolve_handle_ref(const uint16_t slot, const uint16_t generation);
+    }  // namespace detail
+
+    // Stable reference to a task in the Manager (slot + generation).
+    // It never points to other task even if the task is erased and its slot is reused.
+    // Erased (stale) handle is resolved to nullptr.
+    template <typename TaskType = Base>
+    class Handle {
+        uint16_t slot {0xFFFF};
+        uint16_t generation {0};
+
+    public:
+        Handle() {}
+        Handle(const uint16_t slot, const uint16_t generation) : slot(slot), generation(generation) {}
+
+        // implicit upcast only (e.g. Handle<Speak> -> Handle<Base>)
+        template <typename U>
+        Handle(const Handle<U>& h) : slot(h.getSlot()), generation(h.getGeneration()) {
+            TaskType* check = static_cast<U*>(nullptr);
+            (void)check;
+        }
+
+        uint16_t getSlot() const {
+            return slot;
+        }
+        uint16_t getGeneration() const {
+            return generation;
+        }
+
+        bool isValid() const {
+            return detail::resolve_handle(slot, generation) != nullptr;
+        }
+        explicit operator bool() const {
+            return isValid();
+        }
+
+        TaskType* get() const {
+            return static_cast<TaskType*>(detail::resolve_handle(slot, generation));
+        }
+        TaskType* operator->() const {
+            TaskType* t = get();
+            if (!t) LOG_ERROR("Task handle is stale: slot", slot, "generation", generation);
+            return t;
+        }
+        TaskType& operator*() const {
+            return *operator->();
+        }
+
+        operator Ref<TaskType>() const {
+            return detail::ref_cast<TaskType>(detail::resolve_handle_ref(slot, generation));
+        }
+
+        bool operator==(const Handle& h) const {
+            return (slot == h.slot) && (generation == h.generation);
+        }
+        bool operator!=(const Handle& h) const {
+            return !(*this == h);
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_HANDLE_H
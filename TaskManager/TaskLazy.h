@@ -0,0 +1,111 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_LAZY_H
+#define ARDUINO_TASK_MANAGER_TASK_LAZY_H
+
+#include <Arduino.h>
+
+#include "TaskPool.h"
+#include "TaskTraits.h"
+
+namespace arduino {
+namespace task {
+
+    // Container which is allocated when it is modified first.
+    // Tasks without subtasks have only a pointer instead of the subtask containers,
+    // and reading an empty one returns the shared empty container (nothing is allocated).
+    template <typename T>
+    class Lazy {
+        T* p {nullptr};
+
+    public:
+        Lazy() {}
+        Lazy(const Lazy& l) : p(l.p ? create(*l.p) : nullptr) {}
+        Lazy(Lazy&& l) : p(l.p) {
+            l.p = nullptr;
+        }
+        Lazy& operator=(const Lazy& l) {
+            if (this != &l) {
+                reset();
+                if (l.p) p = create(*l.p);
+            }
+            return *this;
+        }
+        Lazy& operator=(Lazy&& l) {
+            if (this != &l) {
+                reset();
+                p = l.p;
+                l.p = nullptr;
+            }
+            return *this;
+        }
+        ~Lazy() {
+            reset();
+        }
+
+        // allocate the container if needed (only for modification)
+        T& get() {
+            if (!p) p = create();
+            return *p;
+        }
+        // release the container
+        void reset() {
+            if (p) destroy(p);
+            p = nullptr;
+        }
+        bool allocated() const {
+            return p != nullptr;
+        }
+
+        const T& operator*() const {
+            return p ? *p : none();
+        }
+        const T* operator->() const {
+            return p ? p : &none();
+        }
+
+        // read-only container interface
+        auto begin() const -> decltype(static_cast<const T*>(nullptr)->begin()) {
+            return (**this).begin();
+        }
+        auto end() const -> decltype(static_cast<const T*>(nullptr)->end()) {
+            return (**this).end();
+        }
+        size_t size() const {
+            return p ? p->size() : 0;
+        }
+        bool empty() const {
+            return p ? p->empty() : true;
+        }
+        template <typename Index>
+        auto operator[](const Index i) const -> decltype((*static_cast<const T*>(nullptr))[i]) {
+            return (**this)[i];
+        }
+
+    private:
+        static const T& none() {
+            static const T e {};
+            return e;
+        }
+
+        template <typename... Args>
+        static T* create(Args&&... args) {
+#ifdef TASKMANAGER_POOL_SIZE
+            return new (Pool::allocate(sizeof(T))) T(detail::forward<Args>(args)...);
+#else
+            return new T(detail::forward<Args>(args)...);
+#endif
+        }
+        static void destroy(T* t) {
+#ifdef TASKMANAGER_POOL_SIZE
+            t->~T();
+            Pool::deallocate(t, sizeof(T));
+#else
+            delete t;
+#endif
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_LAZY_H
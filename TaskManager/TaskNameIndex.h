@@ -0,0 +1,63 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_NAME_INDEX_H
+#define ARDUINO_TASK_MANAGER_TASK_NAME_INDEX_H
+
+#include <Arduino.h>
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <unordered_map>
+#endif
+
+#include "TaskPool.h"
+
+namespace arduino {
+namespace task {
+
+    // FNV-1a (32bit) hash of the task name
+    inline uint32_t hash_name(const String& name) {
+        uint32_t h = 2166136261UL;
+        for (const char* p = name.c_str(); *p; ++p) {
+            h ^= (uint8_t)*p;
+            h *= 16777619UL;
+        }
+        return h;
+    }
+
+#ifdef TASKMANAGER_NAME_HASH
+    // only the hash of the name is stored in the task (no String and no heap)
+    using TaskName = uint32_t;
+    inline TaskName make_name(const String& name) {
+        return hash_name(name);
+    }
+#else
+    using TaskName = String;
+    inline const TaskName& make_name(const String& name) {
+        return name;
+    }
+#endif
+
+    struct NameHash {
+        size_t operator()(const String& name) const {
+            return (size_t)hash_name(name);
+        }
+        size_t operator()(const uint32_t h) const {
+            return (size_t)h;
+        }
+    };
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+    // maps name to the first task added with that name
+#ifdef TASKMANAGER_POOL_SIZE
+    template <typename T>
+    using NameIndex = std::unordered_map<TaskName, T, NameHash, std::equal_to<TaskName>,
+                                         PoolAllocator<std::pair<const TaskName, T>>>;
+#else
+    template <typename T>
+    using NameIndex = std::unordered_map<TaskName, T, NameHash>;
+#endif
+#endif
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_NAME_INDEX_H
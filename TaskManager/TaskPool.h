@@ -0,0 +1,173 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_POOL_H
+#define ARDUINO_TASK_MANAGER_TASK_POOL_H
+
+#include <Arduino.h>
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <cstddef>
+#include <new>
+#elif defined(TASKMANAGER_POOL_SIZE)
+// NO-STL boards have neither std::allocate_shared nor allocator-aware containers to place in the arena
+#error "TASKMANAGER_POOL_SIZE requires libstdc++: remove it on the boards without STL"
+#endif
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+
+namespace arduino {
+namespace task {
+
+    // Fixed-capacity arena of Capacity bytes (Tag distinguishes arenas which have the same capacity).
+    // Blocks are carved from static storage in power-of-two size classes and recycled by per-class free lists.
+    // If the arena is exhausted (or the block is too large), the block falls back to the heap and is counted.
+    template <size_t Capacity, typename Tag>
+    class BasicPool {
+        static constexpr size_t MIN_BLOCK_SIZE = 8;
+        static constexpr size_t NUM_SIZE_CLASSES = 12;  // 8 - 16384 [bytes]
+        static constexpr size_t ALIGN = alignof(std::max_align_t);
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct State {
+            alignas(std::max_align_t) uint8_t buffer[Capacity];
+            size_t carved;      // bytes carved from buffer (never decreases)
+            size_t used;        // bytes in live blocks
+            size_t high_water;  // max of used
+            size_t fallbacks;   // number of blocks allocated from heap
+            FreeBlock* free_list[NUM_SIZE_CLASSES];
+        };
+
+        static State& state() {
+            static State s;
+            return s;
+        }
+
+        static size_t size_class(const size_t n) {
+            size_t c = 0;
+            while ((c < NUM_SIZE_CLASSES) && ((MIN_BLOCK_SIZE << c) < n)) ++c;
+            return c;
+        }
+
+        static bool contains(const void* p) {
+            const uint8_t* b = static_cast<const uint8_t*>(p);
+            return (b >= state().buffer) && (b < state().buffer + Capacity);
+        }
+
+    public:
+        static void* allocate(const size_t n) {
+            State& s = state();
+            const size_t c = size_class(n);
+            if (c < NUM_SIZE_CLASSES) {
+                const size_t block_size = MIN_BLOCK_SIZE << c;
+                void* p = nullptr;
+                if (s.free_list[c]) {
+                    p = s.free_list[c];
+                    s.free_list[c] = s.free_list[c]->next;
+                } else {
+                    const size_t offset = (s.carved + ALIGN - 1) & ~(ALIGN - 1);
+                    if (offset + block_size <= Capacity) {
+                        p = s.buffer + offset;
+                        s.carved = offset + block_size;
+                    }
+                }
+                if (p) {
+                    s.used += block_size;
+                    if (s.used > s.high_water) s.high_water = s.used;
+                    return p;
+                }
+            }
+            ++s.fallbacks;
+            LOG_WARN("Task pool exhausted: allocate", n, "bytes from heap");
+            return ::operator new(n);
+        }
+
+        static void deallocate(void* p, const size_t n) {
+            if (!p) return;
+            const size_t c = size_class(n);
+            if (!contains(p) || (c >= NUM_SIZE_CLASSES)) {  // oversize blocks are always from the heap
+                ::operator delete(p);
+                return;
+            }
+            State& s = state();
+            FreeBlock* b = static_cast<FreeBlock*>(p);
+            b->next = s.free_list[c];
+            s.free_list[c] = b;
+            s.used -= MIN_BLOCK_SIZE << c;
+        }
+
+        static size_t capacity() {
+            return Capacity;
+        }
+        static size_t carvedBytes() {
+            return state().carved;
+        }
+        static size_t usedBytes() {
+            return state().used;
+        }
+        static size_t highWaterMark() {
+            return state().high_water;
+        }
+        static size_t fallbacks() {
+            return state().fallbacks;
+        }
+
+        static void printStats(Print& p) {
+            p.print("pool capacity = ");
+            p.print((unsigned long)capacity());
+            p.print(", carved = ");
+            p.print((unsigned long)carvedBytes());
+            p.print(", used = ");
+            p.print((unsigned long)usedBytes());
+            p.print(", high water mark = ");
+            p.print((unsigned long)highWaterMark());
+            p.print(", heap fallbacks = ");
+            p.println((unsigned long)fallbacks());
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#ifdef TASKMANAGER_POOL_SIZE
+
+namespace arduino {
+namespace task {
+
+    // arena for tasks, subtask vectors and the Manager's containers
+    using Pool = BasicPool<TASKMANAGER_POOL_SIZE, struct TaskPoolTag>;
+
+    template <typename T>
+    struct PoolAllocator {
+        using value_type = T;
+
+        PoolAllocator() {}
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) {}
+
+        T* allocate(const size_t n) {
+            return static_cast<T*>(Pool::allocate(n * sizeof(T)));
+        }
+        void deallocate(T* p, const size_t n) {
+            Pool::deallocate(p, n * sizeof(T));
+        }
+    };
+
+    template <typename T, typename U>
+    inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+        return true;
+    }
+    template <typename T, typename U>
+    inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+        return false;
+    }
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // TASKMANAGER_POOL_SIZE
+
+#endif  // Have libstdc++11
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_POOL_H
@@ -0,0 +1,144 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_PROFILER_H
+#define ARDUINO_TASK_MANAGER_TASK_PROFILER_H
+
+#include <Arduino.h>
+
+#ifdef TASKMANAGER_PROFILER_ENABLE
+
+#ifndef TASKMANAGER_PROFILER_BUCKETS
+#define TASKMANAGER_PROFILER_BUCKETS 16
+#endif  // TASKMANAGER_PROFILER_BUCKETS
+
+namespace arduino {
+namespace task {
+
+    // execution cost and schedule jitter of one task (enabled by TASKMANAGER_PROFILER_ENABLE)
+    struct Profile {
+        // update() calls (self time, without subtasks)
+        uint32_t calls {0};
+        uint32_t min_us {0xFFFFFFFF};
+        uint32_t max_us {0};
+        uint64_t total_us {0};
+        // bucket 0: 0us, bucket i: [2^(i-1), 2^i) us, last bucket: longer than that
+        uint32_t histogram[TASKMANAGER_PROFILER_BUCKETS] {};
+
+        // lateness of update() from the time of its frame
+        uint32_t min_late_us {0xFFFFFFFF};
+        uint32_t max_late_us {0};
+        uint64_t total_late_us {0};
+
+        // enter() and exit() calls
+        uint32_t enter_calls {0};
+        uint32_t exit_calls {0};
+        uint64_t enter_exit_us {0};
+
+        // update_recursive() (including subtasks)
+        uint32_t recursive_calls {0};
+        uint64_t recursive_us {0};
+
+        void reset() {
+            *this = Profile();
+        }
+
+        void addUpdate(const uint32_t us, const uint32_t late_us) {
+            ++calls;
+            if (us < min_us) min_us = us;
+            if (us > max_us) max_us = us;
+            total_us += us;
+            ++histogram[bucket(us)];
+
+            if (late_us < min_late_us) min_late_us = late_us;
+            if (late_us > max_late_us) max_late_us = late_us;
+            total_late_us += late_us;
+        }
+        void addEnter(const uint32_t us) {
+            ++enter_calls;
+            enter_exit_us += us;
+        }
+        void addExit(const uint32_t us) {
+            ++exit_calls;
+            enter_exit_us += us;
+        }
+        void addRecursive(const uint32_t us) {
+            ++recursive_calls;
+            recursive_us += us;
+        }
+
+        uint32_t minUsec() const {
+            return calls ? min_us : 0;
+        }
+        uint32_t maxUsec() const {
+            return max_us;
+        }
+        double avgUsec() const {
+            return calls ? (double)total_us / (double)calls : 0.;
+        }
+        uint32_t minLatenessUsec() const {
+            return calls ? min_late_us : 0;
+        }
+        uint32_t maxLatenessUsec() const {
+            return max_late_us;
+        }
+        double avgLatenessUsec() const {
+            return calls ? (double)total_late_us / (double)calls : 0.;
+        }
+
+        // lower bound [us] of the histogram bucket
+        static uint32_t bucketLowerUsec(const size_t i) {
+            return (i == 0) ? 0 : ((uint32_t)1 << (i - 1));
+        }
+        static size_t bucket(uint32_t us) {
+            size_t i = 0;
+            while (us) {
+                us >>= 1;
+                ++i;
+            }
+            return (i < TASKMANAGER_PROFILER_BUCKETS) ? i : (TASKMANAGER_PROFILER_BUCKETS - 1);
+        }
+
+        void print(Print& p) const {
+            p.print("calls = ");
+            p.print((unsigned long)calls);
+            p.print(", min/avg/max = ");
+            p.print((unsigned long)minUsec());
+            p.print("/");
+            p.print(avgUsec());
+            p.print("/");
+            p.print((unsigned long)maxUsec());
+            p.print(" us, late min/avg/max = ");
+            p.print((unsigned long)minLatenessUsec());
+            p.print("/");
+            p.print(avgLatenessUsec());
+            p.print("/");
+            p.print((unsigned long)maxLatenessUsec());
+            p.print(" us, enter/exit = ");
+            p.print((unsigned long)enter_calls);
+            p.print("/");
+            p.print((unsigned long)exit_calls);
+            p.print(" (");
+            p.print((unsigned long)enter_exit_us);
+            p.print(" us), recursive = ");
+            p.print((unsigned long)recursive_us);
+            p.println(" us");
+
+            // non-empty buckets only: "[lower us]count"
+            p.print("  histogram:");
+            for (size_t i = 0; i < TASKMANAGER_PROFILER_BUCKETS; ++i) {
+                if (histogram[i] == 0) continue;
+                p.print(" [");
+                p.print((unsigned long)bucketLowerUsec(i));
+                p.print(i + 1 < TASKMANAGER_PROFILER_BUCKETS ? "-" : "+");
+                p.print("]");
+                p.print((unsigned long)histogram[i]);
+            }
+            p.println();
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // TASKMANAGER_PROFILER_ENABLE
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_PROFILER_H
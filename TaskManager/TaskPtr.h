@@ -0,0 +1,62 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_PTR_H
+#define ARDUINO_TASK_MANAGER_TASK_PTR_H
+
+#include <Arduino.h>
+
+namespace arduino {
+namespace task {
+
+    // Non-owning pointer to a task which is used as Ref<T> with TASKMANAGER_UNIQUE_OWNERSHIP.
+    // Tasks are owned only by the Manager (or the parent task) and deleted when they are erased,
+    // so copying this pointer costs nothing (no control block and no reference count).
+    // It has the subset of the std::shared_ptr interface which is used by the library and sketches.
+    template <typename T>
+    class Ptr {
+        T* p {nullptr};
+
+    public:
+        Ptr() {}
+        Ptr(decltype(nullptr)) {}
+        explicit Ptr(T* p) : p(p) {}
+
+        // implicit upcast only (e.g. Ptr<Speak> -> Ptr<Base>)
+        template <typename U>
+        Ptr(const Ptr<U>& u) : p(u.get()) {}
+
+        T* get() const {
+            return p;
+        }
+        T* operator->() const {
+            return p;
+        }
+        T& operator*() const {
+            return *p;
+        }
+        explicit operator bool() const {
+            return p != nullptr;
+        }
+        void reset() {
+            p = nullptr;
+        }
+
+        template <typename U>
+        bool operator==(const Ptr<U>& u) const {
+            return p == u.get();
+        }
+        template <typename U>
+        bool operator!=(const Ptr<U>& u) const {
+            return p != u.get();
+        }
+        bool operator==(decltype(nullptr)) const {
+            return p == nullptr;
+        }
+        bool operator!=(decltype(nullptr)) const {
+            return p != nullptr;
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_PTR_H
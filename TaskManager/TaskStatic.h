@@ -0,0 +1,210 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_STATIC_H
+#define ARDUINO_TASK_MANAGER_TASK_STATIC_H
+
+#include <Arduino.h>
+#include <FrameRateCounter.h>
+
+#include "TaskTraits.h"
+
+namespace arduino {
+namespace task {
+
+    // Task for StaticManager: no name, no subtasks, no heap and no virtual hooks.
+    // Define only the hooks which are needed in the derived class, others are skipped at compile time.
+    // Timing is controlled by the same start* methods of FrameRateCounter as Base.
+    class StaticBase : public FrameRateCounter {
+    public:
+        void begin() {}
+        void enter() {}
+        void update() {}
+        void exit() {}
+        void idle() {}
+    };
+
+    namespace detail {
+
+        // true if TaskType (or one of its bases other than StaticBase) declares the hook
+        template <typename TaskType>
+        struct static_hooks {
+            static constexpr bool begin = !is_same<decltype(&TaskType::begin), void (StaticBase::*)()>::value;
+            static constexpr bool enter = !is_same<decltype(&TaskType::enter), void (StaticBase::*)()>::value;
+            static constexpr bool update = !is_same<decltype(&TaskType::update), void (StaticBase::*)()>::value;
+            static constexpr bool exit = !is_same<decltype(&TaskType::exit), void (StaticBase::*)()>::value;
+            static constexpr bool idle = !is_same<decltype(&TaskType::idle), void (StaticBase::*)()>::value;
+        };
+
+        template <typename TaskType>
+        inline void static_begin(TaskType& t, bool_tag<true>) {
+            t.begin();
+        }
+        template <typename TaskType>
+        inline void static_begin(TaskType&, bool_tag<false>) {}
+        template <typename TaskType>
+        inline void static_enter(TaskType& t, bool_tag<true>) {
+            t.enter();
+        }
+        template <typename TaskType>
+        inline void static_enter(TaskType&, bool_tag<false>) {}
+        template <typename TaskType>
+        inline void static_update(TaskType& t, bool_tag<true>) {
+            t.update();
+        }
+        template <typename TaskType>
+        inline void static_update(TaskType&, bool_tag<false>) {}
+        template <typename TaskType>
+        inline void static_exit(TaskType& t, bool_tag<true>) {
+            t.exit();
+        }
+        template <typename TaskType>
+        inline void static_exit(TaskType&, bool_tag<false>) {}
+        template <typename TaskType>
+        inline void static_idle(TaskType& t, bool_tag<true>) {
+            t.idle();
+        }
+        template <typename TaskType>
+        inline void static_idle(TaskType&, bool_tag<false>) {}
+
+        // same procedure as Base::update_recursive() without subtasks
+        template <typename TaskType>
+        inline void static_update_task(TaskType& t) {
+            using Hooks = static_hooks<TaskType>;
+            if (t.isRunning()) {
+                if (t.hasStarted()) {
+                    t.releaseEventTrigger();  // disable hasStopped()
+                    static_enter(t, bool_tag<Hooks::enter>());
+                }
+                if (t.FrameRateCounter::update()) static_update(t, bool_tag<Hooks::update>());
+            } else {
+                static_idle(t, bool_tag<Hooks::idle>());
+            }
+            // for external trigger
+            if (t.hasStopped()) {
+                t.releaseEventTrigger();  // disable hasStopped()
+                static_exit(t, bool_tag<Hooks::exit>());
+            }
+        }
+
+        // tasks are held by value in a recursive list (no std::tuple on NO-STL boards)
+        template <typename... TaskTypes>
+        struct StaticTasks;
+
+        template <>
+        struct StaticTasks<> {
+            void begin() {}
+            void update() {}
+            void stop() {}
+            template <typename F>
+            void for_each(F&) {}
+        };
+
+        template <typename TaskType, typename... Rest>
+        struct StaticTasks<TaskType, Rest...> {
+            TaskType task;
+            StaticTasks<Rest...> rest;
+
+            void begin() {
+                static_begin(task, bool_tag<static_hooks<TaskType>::begin>());
+                rest.begin();
+            }
+            void update() {
+                static_update_task(task);
+                rest.update();
+            }
+            void stop() {
+                task.stop();
+                rest.stop();
+            }
+            template <typename F>
+            void for_each(F& f) {
+                f(task);
+                rest.for_each(f);
+            }
+        };
+
+        // I-th task
+        template <size_t I, typename... TaskTypes>
+        struct static_at;
+
+        template <typename TaskType, typename... Rest>
+        struct static_at<0, TaskType, Rest...> {
+            using type = TaskType;
+            static type& get(StaticTasks<TaskType, Rest...>& tasks) {
+                return tasks.task;
+            }
+        };
+
+        template <size_t I, typename TaskType, typename... Rest>
+        struct static_at<I, TaskType, Rest...> {
+            using type = typename static_at<I - 1, Rest...>::type;
+            static type& get(StaticTasks<TaskType, Rest...>& tasks) {
+                return static_at<I - 1, Rest...>::get(tasks.rest);
+            }
+        };
+
+        // index of the first task of the type
+        template <typename T, typename... TaskTypes>
+        struct static_index;
+
+        template <typename T, typename... Rest>
+        struct static_index<T, T, Rest...> {
+            static constexpr size_t value = 0;
+        };
+
+        template <typename T, typename TaskType, typename... Rest>
+        struct static_index<T, TaskType, Rest...> {
+            static constexpr size_t value = 1 + static_index<T, Rest...>::value;
+        };
+
+    }  // namespace detail
+
+    // Task table fixed at compile time: tasks are members of this object (no heap),
+    // hooks are called without virtual dispatch and the update loop is unrolled.
+    //
+    //   Task::StaticManager<Blink, Speak> tasks;
+    //   tasks.begin();                    // in setup()
+    //   tasks.get<Blink>().startFps(1.);  // or tasks.get<0>()
+    //   tasks.update();                   // in loop()
+    template <typename... TaskTypes>
+    class StaticManager {
+        detail::StaticTasks<TaskTypes...> tasks;
+
+    public:
+        // call begin() of all tasks (call this in setup())
+        void begin() {
+            tasks.begin();
+        }
+
+        void update() {
+            tasks.update();
+        }
+
+        void stop() {
+            tasks.stop();
+        }
+
+        // call f(task) for all tasks (f should accept every task type, e.g. StaticBase&)
+        template <typename F>
+        void forEach(F&& f) {
+            tasks.for_each(f);
+        }
+
+        template <size_t I>
+        typename detail::static_at<I, TaskTypes...>::type& get() {
+            return detail::static_at<I, TaskTypes...>::get(tasks);
+        }
+
+        template <typename TaskType>
+        TaskType& get() {
+            return get<detail::static_index<TaskType, TaskTypes...>::value>();
+        }
+
+        static constexpr size_t size() {
+            return sizeof...(TaskTypes);
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_STATIC_H
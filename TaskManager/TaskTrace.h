@@ -0,0 +1,159 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_TRACE_H
+#define ARDUINO_TASK_MANAGER_TASK_TRACE_H
+
+#include <Arduino.h>
+
+#ifdef TASKMANAGER_TRACE_ENABLE
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <atomic>
+#endif
+
+// number of events in the ring buffer (power of 2, 12 bytes each)
+#ifndef TASKMANAGER_TRACE_SIZE
+#define TASKMANAGER_TRACE_SIZE 128
+#endif  // TASKMANAGER_TRACE_SIZE
+
+namespace arduino {
+namespace task {
+
+    // one call of a hook of a task (or one sleep of the Manager)
+    struct TraceEvent {
+        enum Type : uint8_t { ENTER = 0, UPDATE = 1, EXIT = 2, IDLE = 3, SLEEP = 4 };
+
+        uint32_t begin_us;  // micros() at the beginning
+        uint32_t id;        // Base::getTraceId() of the task (0 for SLEEP)
+        uint32_t info;      // type (upper 8 bits) and duration [us] (lower 24 bits, saturated)
+
+        Type type() const {
+            return (Type)(info >> 24);
+        }
+        uint32_t durationUsec() const {
+            return info & 0x00FFFFFF;
+        }
+    };
+
+    // fixed-size ring buffer of the latest TraceEvents (enabled by TASKMANAGER_TRACE_ENABLE)
+    // recording is lock-free: a slot is claimed by incrementing the head, and the oldest events are overwritten
+    class Trace {
+        static_assert((TASKMANAGER_TRACE_SIZE & (TASKMANAGER_TRACE_SIZE - 1)) == 0,
+                      "TASKMANAGER_TRACE_SIZE must be a power of 2");
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+        std::atomic<uint32_t> head {0};  // number of events recorded so far
+        std::atomic<uint32_t> ids {0};   // number of tasks constructed so far
+        std::atomic<bool> b_enabled {true};
+#else
+        volatile uint32_t head {0};
+        volatile uint32_t ids {0};
+        volatile bool b_enabled {true};
+#endif
+        TraceEvent events[TASKMANAGER_TRACE_SIZE];
+
+    public:
+        // version of the binary format below
+        static constexpr uint16_t VERSION = 1;
+
+        static Trace& get() {
+            static Trace t;
+            return t;
+        }
+
+        // id of a new task instance (tasks with the same name or without name get different ids)
+        uint32_t nextId() {
+            return ++ids;
+        }
+
+        void record(const TraceEvent::Type type, const uint32_t id, const uint32_t begin_us, const uint32_t us) {
+            if (!b_enabled) return;
+            const uint32_t i = head++;
+            TraceEvent& e = events[i & (TASKMANAGER_TRACE_SIZE - 1)];
+            e.begin_us = begin_us;
+            e.id = id;
+            e.info = ((uint32_t)type << 24) | ((us < 0x00FFFFFF) ? us : 0x00FFFFFF);
+        }
+
+        void enable(const bool b) {
+            b_enabled = b;
+        }
+        bool isEnabled() const {
+            return b_enabled;
+        }
+        void clear() {
+            head = 0;
+        }
+        // number of events in the buffer
+        size_t size() const {
+            const uint32_t n = head;
+            return (n < TASKMANAGER_TRACE_SIZE) ? n : TASKMANAGER_TRACE_SIZE;
+        }
+        // number of events overwritten by newer ones
+        uint32_t lost() const {
+            const uint32_t n = head;
+            return (n < TASKMANAGER_TRACE_SIZE) ? 0 : (n - TASKMANAGER_TRACE_SIZE);
+        }
+        // i-th oldest event in the buffer
+        const TraceEvent& operator[](const size_t i) const {
+            const uint32_t n = head;
+            const uint32_t first = (n < TASKMANAGER_TRACE_SIZE) ? 0 : (n - TASKMANAGER_TRACE_SIZE);
+            return events[(first + i) & (TASKMANAGER_TRACE_SIZE - 1)];
+        }
+
+        // binary format of dump() (all little-endian):
+        //   header: "TMTR", u16 version, u16 reserved, u32 names, u32 events, u32 lost
+        //   names:  u32 id, u8 length, name (without '\0', "#" and 8 hex digits of the hash with TASKMANAGER_NAME_HASH)
+        //   events: u32 begin_us, u32 id, u32 info (oldest first)
+        static size_t writeHeader(Print& p, const uint32_t names, const uint32_t events, const uint32_t lost) {
+            size_t n = p.write((const uint8_t*)"TMTR", 4);
+            n += write16(p, VERSION);
+            n += write16(p, 0);
+            n += write32(p, names);
+            n += write32(p, events);
+            n += write32(p, lost);
+            return n;
+        }
+        static size_t writeName(Print& p, const uint32_t id, const char* name) {
+            size_t len = strlen(name);
+            if (len > 0xFF) len = 0xFF;
+            size_t n = write32(p, id);
+            n += p.write((uint8_t)len);
+            n += p.write((const uint8_t*)name, len);
+            return n;
+        }
+        static size_t writeName(Print& p, const uint32_t id, const uint32_t hash) {
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+            char name[10] = {'#'};
+            for (size_t i = 0; i < 8; ++i) name[1 + i] = HEX_DIGITS[(hash >> (28 - 4 * i)) & 0xF];
+            return writeName(p, id, name);
+        }
+        size_t writeEvents(Print& p, const size_t count) const {
+            size_t n = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const TraceEvent& e = (*this)[i];
+                n += write32(p, e.begin_us);
+                n += write32(p, e.id);
+                n += write32(p, e.info);
+            }
+            return n;
+        }
+
+    private:
+        Trace() = default;
+
+        static size_t write16(Print& p, const uint16_t v) {
+            const uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+            return p.write(b, 2);
+        }
+        static size_t write32(Print& p, const uint32_t v) {
+            const uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+            return p.write(b, 4);
+        }
+    };
+
+}  // namespace task
+}  // namespace arduino
+
+#endif  // TASKMANAGER_TRACE_ENABLE
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_TRACE_H
@@ -0,0 +1,96 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_TASK_TRAITS_H
+#define ARDUINO_TASK_MANAGER_TASK_TRAITS_H
+
+// minimal type traits which are available also on NO-STL boards
+
+namespace arduino {
+namespace task {
+    namespace detail {
+
+        template <typename T, typename U>
+        struct is_same {
+            static constexpr bool value = false;
+        };
+        template <typename T>
+        struct is_same<T, T> {
+            static constexpr bool value = true;
+        };
+
+        template <bool B, typename T = void>
+        struct enable_if {};
+        template <typename T>
+        struct enable_if<true, T> {
+            using type = T;
+        };
+
+        template <bool B>
+        struct bool_tag {};
+
+        template <typename T>
+        struct remove_reference {
+            using type = T;
+        };
+        template <typename T>
+        struct remove_reference<T&> {
+            using type = T;
+        };
+        template <typename T>
+        struct remove_reference<T&&> {
+            using type = T;
+        };
+
+        template <typename T>
+        struct remove_cv {
+            using type = T;
+        };
+        template <typename T>
+        struct remove_cv<const T> {
+            using type = T;
+        };
+        template <typename T>
+        struct remove_cv<volatile T> {
+            using type = T;
+        };
+        template <typename T>
+        struct remove_cv<const volatile T> {
+            using type = T;
+        };
+
+        // std::decay for callables: strips reference / cv and converts function to function pointer
+        template <typename T>
+        struct decay_func_impl {
+            using type = T;
+        };
+        template <typename R, typename... Args>
+        struct decay_func_impl<R(Args...)> {
+            using type = R (*)(Args...);
+        };
+        template <typename T>
+        struct decay_func {
+            using type = typename decay_func_impl<
+                typename remove_cv<typename remove_reference<T>::type>::type>::type;
+        };
+
+        template <typename T>
+        T&& forward(typename remove_reference<T>::type& t) noexcept {
+            return static_cast<T&&>(t);
+        }
+        template <typename T>
+        T&& forward(typename remove_reference<T>::type&& t) noexcept {
+            return static_cast<T&&>(t);
+        }
+
+        template <typename T>
+        typename remove_reference<T>::type&& move(T&& t) noexcept {
+            return static_cast<typename remove_reference<T>::type&&>(t);
+        }
+
+        template <typename T>
+        T&& declval() noexcept;
+
+    }  // namespace detail
+}  // namespace task
+}  // namespace arduino
+
+#endif  // ARDUINO_TASK_MANAGER_TASK_TRAITS_H
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef BLINK_H  // change depending on your class
+#define BLINK_H  // change depending on your class
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#ifndef LED_BUILTIN
+#define LED_BUILTIN 13  // <- change to your own led pin
+#endif
+
+class Blink : public Task::StaticBase {
+    bool b {false};
+
+public:
+    // optional (you can remove this method)
+    void begin() {
+        pinMode(LED_BUILTIN, OUTPUT);
+        digitalWrite(LED_BUILTIN, LOW);
+    }
+
+    void update() {
+        digitalWrite(LED_BUILTIN, b);
+        b = !b;
+    }
+};
+
+#endif  // BLINK_H
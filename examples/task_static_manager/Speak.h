@@ -0,0 +1,28 @@
+#pragma once
+#ifndef SPEAK_H  // change depending on your class
+#define SPEAK_H  // change depending on your class
+
+#include <TaskManager.h>
+
+class Speak : public Task::StaticBase {
+public:
+    // optional (you can remove this method)
+    void begin() {
+        Serial.begin(115200);
+        Serial.println("Task speak begin()");
+    }
+
+    // optional (you can remove this method)
+    void enter() {
+        Serial.println("Task speak enter()");
+    }
+
+    void update() {
+        Serial.print("Task speak update() at frame = ");
+        Serial.print(frame());
+        Serial.print(", time = ");
+        Serial.println(millis());
+    }
+};
+
+#endif  // SPEAK_H
@@ -0,0 +1,17 @@
+#include <TaskManager.h>
+#include "Blink.h"
+#include "Speak.h"
+
+// same tasks as task_class_simple, but fixed at compile time (no heap, no virtual hooks)
+Task::StaticManager<Blink, Speak> tasks;
+
+void setup() {
+    delay(2000);
+    tasks.begin();
+    tasks.get<Blink>().startFps(1.);
+    tasks.get<Speak>().startIntervalSec(0.5);
+}
+
+void loop() {
+    tasks.update();
+}
@@ -0,0 +1,130 @@
+// updateWithBudget() must stop starting due tasks when the budget is spent (at least one task runs),
+// run the tasks in order of priority where the carried-over ones get +1 for every call they wait
+// (so that low priority tasks don't starve), and report the carried-over tasks by its return value
+// and by getBudgetStats().
+//
+//   usage: taskmanager_budget
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    String order;
+
+    // spends cost_us of the virtual clock in every update()
+    class Worker : public Task::Base {
+        const char id;
+        const uint32_t cost_us;
+
+    public:
+        Worker(const String& name, const char id, const uint32_t cost_us) : Base(name), id(id), cost_us(cost_us) {}
+        virtual void update() override {
+            order += id;
+            delayMicroseconds(cost_us);
+        }
+    };
+
+    // number of updates of the task in order (tasks of the same priority may run in any order)
+    size_t runs(const char id) {
+        size_t n = 0;
+        for (unsigned int i = 0; i < order.length(); ++i)
+            if (order[i] == id) ++n;
+        return n;
+    }
+
+    struct Call {
+        size_t carried;
+        uint32_t elapsed_us;
+    };
+
+    Call call(const uint32_t budget_us) {
+        const uint32_t begin_us = (uint32_t)micros();
+        const size_t carried = Tasks.updateWithBudget(budget_us);
+        const Call c {carried, (uint32_t)micros() - begin_us};
+        return c;
+    }
+
+    void run(const Task::SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        Tasks.resetBudgetStats();
+
+        // 300 us each, due every 10 ms
+        Tasks.add<Worker>("a", 'a', 300)->startFps(100.);
+        Tasks.add<Worker>("b", 'b', 300)->startFps(100.);
+        Tasks.add<Worker>("c", 'c', 300)->startFps(100.);
+        Tasks.add<Worker>("h", 'h', 300)->setPriority(5)->startFps(100.);
+
+        // the budget is spent by the third task: the last one is carried over
+        order = "";
+        Call c = call(700);
+        CHECK(order.length() == 3);
+        CHECK(order[0] == 'h');
+        const char carried_id = (runs('a') == 0) ? 'a' : ((runs('b') == 0) ? 'b' : 'c');
+        CHECK(runs(carried_id) == 0);
+        CHECK(c.elapsed_us == 900);  // no task starts after the budget is spent
+        CHECK(c.carried == 1);
+        CHECK(Tasks.getBudgetStats().calls == 1);
+        CHECK(Tasks.getBudgetStats().exhausted == 1);
+        CHECK(Tasks.getBudgetStats().deferred == 1);
+        CHECK(Tasks.getBudgetStats().max_wait == 1);
+
+        // the carried-over task runs in the next call (the others are not due yet)
+        order = "";
+        c = call(700);
+        CHECK(order.length() == 1);
+        CHECK(order[0] == carried_id);
+        CHECK(c.carried == 0);
+        CHECK(Tasks.getBudgetStats().calls == 2);
+        CHECK(Tasks.getBudgetStats().exhausted == 1);
+
+        // all due tasks run if the budget is enough
+        arduino_shim::advanceUsec(10000);
+        order = "";
+        c = call(100000);
+        CHECK(order.length() == 4);
+        CHECK(order[0] == 'h');
+        CHECK((runs('a') == 1) && (runs('b') == 1) && (runs('c') == 1));
+        CHECK(c.carried == 0);
+        CHECK(Tasks.getBudgetStats().exhausted == 1);
+
+        // due in every call, one task per call: h has higher priority, but a and b catch up with it
+        Tasks.clear();
+        Tasks.resetBudgetStats();
+        Tasks.add<Worker>("a", 'a', 300)->startIntervalUsec(100.);
+        Tasks.add<Worker>("b", 'b', 300)->startIntervalUsec(100.);
+        Tasks.add<Worker>("h", 'h', 300)->setPriority(2)->startIntervalUsec(100.);
+        order = "";
+        for (int i = 0; i < 5; ++i) {
+            c = call(1);
+            CHECK(c.elapsed_us == 300);  // at least one task runs
+            CHECK(c.carried == 2);
+        }
+        CHECK(order.length() == 5);
+        CHECK(order[0] == 'h');
+        CHECK(order[1] == 'h');
+        CHECK((runs('a') == 1) && (runs('b') == 1));
+        CHECK(Tasks.getBudgetStats().calls == 5);
+        CHECK(Tasks.getBudgetStats().exhausted == 5);
+        CHECK(Tasks.getBudgetStats().deferred == 10);
+        CHECK(Tasks.getBudgetStats().max_wait == 3);  // b waited for calls 1 - 3
+
+        // update() takes the carried-over tasks back
+        order = "";
+        Tasks.update();
+        CHECK(order.length() == 3);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    run(Task::SchedulerMode::LINEAR);
+    run(Task::SchedulerMode::DEADLINE);
+
+    return check::result("budget");
+}
@@ -0,0 +1,29 @@
+// Minimal assertions for the behavior tests: CHECK() reports the failed condition and the test continues.
+// Each test returns check::result() from main() so that ctest sees the failures.
+
+#pragma once
+
+#include <cstdio>
+
+namespace check {
+
+    inline int& failures() {
+        static int n = 0;
+        return n;
+    }
+
+    inline int result(const char* test) {
+        printf("{\"test\": \"%s\", \"failures\": %d, \"result\": \"%s\"}\n", test, failures(),
+               failures() ? "failed" : "ok");
+        return failures() ? 1 : 0;
+    }
+
+}  // namespace check
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #cond); \
+            ++check::failures();                                             \
+        }                                                                    \
+    } while (0)
@@ -0,0 +1,100 @@
+// A coroutine run by Tasks.spawn() must resume after co_await sleepMs() at the exact due time,
+// in the next update() after co_await nextFrame(), and after the awaited task exits (or is erased)
+// after co_await task->stopped(). Its task is erased when the coroutine returns.
+// TaskCoroutine.h needs C++20: this test is built only if the compiler supports it.
+//
+//   usage: taskmanager_coroutine
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+#ifndef TASKMANAGER_HAS_COROUTINE
+#error "C++20 coroutines are not available: TaskCoroutine.h is not compiled"
+#endif
+
+namespace {
+
+    String events;
+    uint32_t resumed_us = 0;
+
+    Task::Coroutine sleeper() {
+        events += "a ";
+        co_await Task::sleepMs(10);
+        resumed_us = micros();
+        events += "b ";
+        co_await Task::nextFrame();
+        events += "c ";
+    }
+
+    Task::Coroutine waiter(Task::Base* target) {
+        co_await target->stopped();
+        events += "stopped ";
+    }
+
+    void run_sleeper() {
+        events = "";
+        const uint32_t origin_us = micros();
+        const auto h = Tasks.spawn("sleeper", sleeper());
+        CHECK(h.isValid());
+        CHECK(events == "");  // runs from the next update()
+
+        Tasks.update();
+        CHECK(events == "a ");
+        arduino_shim::advanceUsec(9999);
+        Tasks.update();
+        CHECK(events == "a ");
+        arduino_shim::advanceUsec(1);
+        Tasks.update();
+        CHECK(events == "a b ");
+        CHECK(resumed_us - origin_us == 10000);
+
+        // the next update() even if the time doesn't move
+        Tasks.update();
+        CHECK(events == "a b c ");
+
+        // erased when the coroutine returns
+        CHECK(!Tasks.exists("sleeper"));
+        CHECK(!Tasks.isValid(h));
+    }
+
+    void run_waiter(const bool b_erase) {
+        events = "";
+        auto target = Tasks.add("target", [] {});
+        target->startFps(100.);
+        Tasks.spawn("waiter", waiter(target.get()));
+        for (int i = 0; i < 5; ++i) {
+            Tasks.update();
+            arduino_shim::advanceUsec(10000);
+        }
+        CHECK(events == "");
+        CHECK(Tasks.exists("waiter"));
+
+        if (b_erase)
+            Tasks.erase("target");
+        else
+            target->stop();
+        Tasks.update();
+        Tasks.update();
+        CHECK(events == "stopped ");
+        CHECK(!Tasks.exists("waiter"));
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    for (const auto mode : {Task::SchedulerMode::LINEAR, Task::SchedulerMode::DEADLINE}) {
+        Tasks.setSchedulerMode(mode);
+        run_sleeper();
+        run_waiter(false);
+        Tasks.clear();
+        run_waiter(true);
+        Tasks.clear();
+    }
+    CHECK(Tasks.empty());
+
+    return check::result("coroutine");
+}
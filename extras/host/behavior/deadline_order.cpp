@@ -0,0 +1,85 @@
+// SchedulerMode::DEADLINE must update the same tasks as LINEAR, but in the order of their due time
+// (LINEAR updates them in the insertion order). Stopped tasks are not updated in either mode.
+//
+//   usage: taskmanager_deadline_order
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    String order;
+
+    class Probe : public Task::Base {
+        const char id;
+
+    public:
+        Probe(const String& name, const char id) : Base(name), id(id) {}
+
+        virtual void update() override {
+            order += id;
+        }
+    };
+
+    // tasks are added in the reverse order of their due time
+    String run(const Task::SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        Tasks.add<Probe>("a", 'a')->startIntervalMsec(50);
+        Tasks.add<Probe>("b", 'b')->startIntervalMsec(30);
+        Tasks.add<Probe>("c", 'c')->startIntervalMsec(20);
+        Tasks.add<Probe>("d", 'd')->startIntervalMsec(10);
+        auto stopped = Tasks.add<Probe>("stopped", 's');
+        stopped->startIntervalMsec(5);
+        stopped->stop();
+
+        // frame 0 of every task
+        order = "";
+        Tasks.update();
+        CHECK(order.length() == 4);
+        CHECK(Tasks.nextDeadlineUsec() == 10000);
+
+        // no task is due
+        order = "";
+        arduino_shim::advanceUsec(9000);
+        Tasks.update();
+        CHECK(order == "");
+        CHECK(Tasks.nextDeadlineUsec() == 1000);
+
+        // all tasks are overdue (d at 10 ms, c at 20 ms, b at 30 ms, a at 50 ms)
+        order = "";
+        arduino_shim::advanceUsec(46000);
+        Tasks.update();
+        const String overdue = order;
+        CHECK(Tasks.nextDeadlineUsec() == 5000);  // d at 60 ms
+
+        // nothing is left for the same time
+        order = "";
+        Tasks.update();
+        CHECK(order == "");
+        return overdue;
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    const String linear = run(Task::SchedulerMode::LINEAR);
+    const String deadline = run(Task::SchedulerMode::DEADLINE);
+    CHECK(linear == "abcd");
+    CHECK(deadline == "dcba");
+
+    // every control leaves a stale entry in the heap (compacted when too many): updated once anyway
+    Tasks.clear();
+    auto t = Tasks.add<Probe>("t", 't');
+    for (int i = 0; i < 100; ++i) t->startIntervalMsec(10);
+    order = "";
+    Tasks.update();
+    CHECK(order == "t");
+    CHECK(Tasks.nextDeadlineUsec() == 10000);
+
+    return check::result("deadline_order");
+}
@@ -0,0 +1,95 @@
+// A task started by startOnEvent() must stay idle without notify() however long the time goes,
+// run update() only once for multiple notify() before the next update() (getNotifyCount() is the number of them),
+// and stay event-triggered after restart() (other start methods switch it back to time-driven).
+//
+//   usage: taskmanager_event_notify
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    int updates = 0;
+    uint16_t last_notify_count = 0;
+
+    class Listener : public Task::Base {
+    public:
+        Listener(const String& name) : Base(name) {}
+        virtual void update() override {
+            ++updates;
+            last_notify_count = getNotifyCount();
+        }
+    };
+
+    void update_for(const uint32_t usec) {
+        for (uint32_t i = 0; i < usec / 1000; ++i) {
+            arduino_shim::advanceUsec(1000);
+            Tasks.update();
+        }
+    }
+
+    void run(const Task::SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        auto h = Tasks.add<Listener>("listener");
+        Task::Base* t = h.get();
+        t->startOnEvent();
+        CHECK(t->isEventTriggered());
+
+        // idle without notify()
+        updates = 0;
+        update_for(100000);
+        CHECK(updates == 0);
+
+        // coalesced into one update()
+        t->notify();
+        Tasks.notify("listener");
+        Tasks.notify(h);
+        CHECK(t->isNotified());
+        Tasks.update();
+        CHECK(updates == 1);
+        CHECK(last_notify_count == 3);
+        CHECK(!t->isNotified());
+        update_for(100000);
+        CHECK(updates == 1);
+
+        // each update() gets the notify() after the previous one
+        t->notify();
+        Tasks.update();
+        CHECK(updates == 2);
+        CHECK(last_notify_count == 1);
+
+        // restart() calls update() once by itself, drops the pending notify() and keeps waiting for the next one
+        t->notify();
+        t->restart();
+        CHECK(updates == 3);
+        CHECK(t->isEventTriggered());
+        CHECK(!t->isNotified());
+        update_for(100000);
+        CHECK(updates == 3);
+        t->notify();
+        Tasks.update();
+        CHECK(updates == 4);
+        CHECK(last_notify_count == 1);
+
+        // other start methods switch it back to time-driven
+        t->startFps(100.);
+        CHECK(!t->isEventTriggered());
+        Tasks.update();  // frame 0
+        updates = 0;
+        update_for(100000);
+        CHECK(updates == 10);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    run(Task::SchedulerMode::LINEAR);
+    run(Task::SchedulerMode::DEADLINE);
+
+    return check::result("event_notify");
+}
@@ -0,0 +1,92 @@
+// With Tasks.setWorkers(n), every due task must be updated exactly once per frame on the workers,
+// tasks pinned by setAffinity(i) must always run on the same worker (one worker per index),
+// and tasks with setMainThread(true) must run on the thread which calls Tasks.update().
+// Run it under ThreadSanitizer to check the hand-off between the workers and the Manager.
+//
+//   usage: taskmanager_executor
+
+#define TASKMANAGER_EXECUTOR_ENABLE
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+namespace {
+
+    constexpr size_t NUM_WORKERS = 4;
+    constexpr size_t NUM_TASKS = 64;
+    constexpr int NUM_FRAMES = 50;
+
+    class Recorder : public Task::Base {
+    public:
+        int updates {0};
+        bool b_same_thread {true};  // all updates on thread
+        std::thread::id thread;
+
+        Recorder(const String& name) : Base(name) {}
+        virtual void update() override {
+            const std::thread::id id = std::this_thread::get_id();
+            if ((updates > 0) && (id != thread)) b_same_thread = false;
+            thread = id;
+            ++updates;
+        }
+    };
+
+    void run(const Task::SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        Tasks.setWorkers(NUM_WORKERS);
+        CHECK(Tasks.getWorkers() == NUM_WORKERS);
+
+        // every 4th task is pinned, every 8th task runs on the main thread
+        std::vector<Recorder*> recorders;
+        for (size_t i = 0; i < NUM_TASKS; ++i) {
+            auto t = Tasks.add<Recorder>(String("task") + String((unsigned long)i));
+            if (i % 8 == 1) t->setMainThread(true);
+            if (i % 4 == 2) t->setAffinity((int8_t)((i / 4) % NUM_WORKERS));
+            t->startFps(100.);
+            recorders.push_back(t.get());
+        }
+
+        for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+            Tasks.update();
+            for (auto* r : recorders) CHECK(r->updates == frame + 1);
+            arduino_shim::advanceUsec(10000);
+        }
+
+        const std::thread::id main_thread = std::this_thread::get_id();
+        std::thread::id workers[NUM_WORKERS];
+        for (size_t i = 0; i < NUM_TASKS; ++i) {
+            const Recorder* r = recorders[i];
+            if (i % 8 == 1) {
+                CHECK(r->b_same_thread);
+                CHECK(r->thread == main_thread);
+            } else if (i % 4 == 2) {
+                CHECK(r->b_same_thread);
+                CHECK(r->thread != main_thread);
+                // the first task pinned to each worker tells its thread
+                std::thread::id& w = workers[(i / 4) % NUM_WORKERS];
+                if (w == std::thread::id()) w = r->thread;
+                CHECK(r->thread == w);
+            }
+        }
+        for (size_t i = 0; i < NUM_WORKERS; ++i)
+            for (size_t j = i + 1; j < NUM_WORKERS; ++j) CHECK(workers[i] != workers[j]);
+
+        Tasks.setWorkers(0);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    run(Task::SchedulerMode::LINEAR);
+    run(Task::SchedulerMode::DEADLINE);
+
+    return check::result("executor");
+}
@@ -0,0 +1,100 @@
+// Bulk control of a group must reach every member even if members are erased while it runs,
+// and an erased task must leave its groups (a new task in the same slot is not a member).
+//
+//   usage: taskmanager_group_erase
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    int calls = 0;
+
+    void add_members(Task::Group& g, const int n) {
+        for (int i = 0; i < n; ++i) g.add(Tasks.add(String("m") + String(i), [] {}));
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    // erase the current member
+    {
+        Tasks.clear();
+        auto g = Tasks.group("self");
+        add_members(g, 4);
+        calls = 0;
+        g.forEach([](Task::Base& t) {
+            ++calls;
+            const String name = t.getName();
+            Tasks.erase(name);
+        });
+        CHECK(calls == 4);
+        CHECK(g.empty());
+        CHECK(Tasks.size() == 0);
+    }
+
+    // erase an earlier member from a later one (the rest shift in the group)
+    {
+        Tasks.clear();
+        auto g = Tasks.group("earlier");
+        add_members(g, 4);
+        calls = 0;
+        g.forEach([](Task::Base& t) {
+            ++calls;
+            if (t.getName() == "m1") Tasks.erase("m0");
+        });
+        CHECK(calls == 4);
+        CHECK(g.size() == 3);
+    }
+
+    // erase a later member: it is not called anymore
+    {
+        Tasks.clear();
+        auto g = Tasks.group("later");
+        add_members(g, 4);
+        calls = 0;
+        g.forEach([](Task::Base& t) {
+            ++calls;
+            if (t.getName() == "m0") Tasks.erase("m2");
+        });
+        CHECK(calls == 3);
+        CHECK(g.size() == 3);
+    }
+
+    // task methods: auto-erased members stop and are erased by restart() -> update()
+    {
+        Tasks.clear();
+        auto g = Tasks.group("methods");
+        add_members(g, 4);
+        g.setAutoErase(true);
+        g.startFps(100.);
+        CHECK(Tasks.getActiveTaskSize() == 4);
+        g.stop();
+        Tasks.update();
+        CHECK(g.empty());
+        CHECK(Tasks.size() == 0);
+    }
+
+    // membership after erase: the slot is reused by a task which is not a member
+    {
+        Tasks.clear();
+        auto g = Tasks.group("reuse");
+        auto h = Tasks.add("a", [] {});
+        g.add(h);
+        Tasks.erase("a");
+        CHECK(g.size() == 0);
+        CHECK(!g.contains(h));
+        auto h2 = Tasks.add("b", [] {});
+        CHECK(h2.getSlot() == h.getSlot());
+        CHECK(!g.contains(h2));
+        calls = 0;
+        g.forEach([](Task::Base&) { ++calls; });
+        CHECK(calls == 0);
+    }
+
+    return check::result("group_erase");
+}
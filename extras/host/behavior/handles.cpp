@@ -0,0 +1,106 @@
+// A handle of an erased task must stay invalid even after a new task reuses its slot:
+// it must not resolve to, update, control or erase the new task (also after Tasks.clear()).
+//
+//   usage: taskmanager_handles
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    int updates = 0;
+
+    void check_stale(const TaskHandle<>& old, const TaskHandle<>& reused) {
+        CHECK(!old.isValid());
+        CHECK(!old);
+        CHECK(old.get() == nullptr);
+        CHECK(!Tasks.isValid(old));
+        CHECK(!Tasks.getTaskByHandle(old));
+        CHECK(old != reused);
+
+        // a stale handle doesn't reach the new task in the same slot
+        CHECK(!Tasks.notify(old));
+        CHECK(Tasks.post(old, Task::Command::stop()));  // queued, but dropped in update()
+        updates = 0;
+        Tasks.update();
+        Tasks.update(old);
+        CHECK(updates == 1);
+        CHECK(reused->isRunning());
+        CHECK(!Tasks.erase(old));
+        CHECK(reused.isValid());
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    // erase() and add(): the slot is reused with a new generation
+    {
+        Tasks.clear();
+        TaskHandle<> a = Tasks.add("a", [] { ++updates; });
+        TaskHandle<> b = Tasks.add("b", [] {});
+        CHECK(a.isValid() && b.isValid());
+        CHECK(a != b);
+        CHECK(Tasks.getTaskByHandle(a) == Tasks.getTaskByName("a"));
+
+        const TaskHandle<> old = a;
+        CHECK(Tasks.erase(a));
+        CHECK(!old.isValid());
+        CHECK(!Tasks.erase(a));
+        CHECK(b.isValid());
+
+        TaskHandle<> c = Tasks.add("c", [] { ++updates; });
+        c->startFps(1000);
+        CHECK(c.getSlot() == old.getSlot());
+        CHECK(c.getGeneration() != old.getGeneration());
+        check_stale(old, c);
+        CHECK(Tasks.size() == 2);
+    }
+
+    // clear() invalidates all handles, and the new tasks don't match them
+    {
+        Tasks.clear();
+        TaskHandle<> a = Tasks.add("a", [] { ++updates; });
+        const TaskHandle<> old = a;
+        Tasks.clear();
+        CHECK(!old.isValid());
+        CHECK(Tasks.size() == 0);
+
+        TaskHandle<> c = Tasks.add("c", [] { ++updates; });
+        c->startFps(1000);
+        CHECK(c.getSlot() == old.getSlot());
+        check_stale(old, c);
+    }
+
+    // a default-constructed handle is never valid
+    {
+        const TaskHandle<> none;
+        CHECK(!none.isValid());
+        CHECK(!Tasks.getTaskByHandle(none));
+        CHECK(!Tasks.erase(none));
+    }
+
+    // erase(name) finds the task through the name index: only the handles of that name become stale
+    {
+        Tasks.clear();
+        const TaskHandle<> a = Tasks.add("a", [] {});
+        const TaskHandle<> b = Tasks.add("b", [] {});
+        CHECK(Tasks.erase("a"));
+        CHECK(!Tasks.isValid(a));
+        CHECK(Tasks.isValid(b));
+        CHECK(!Tasks.erase("a"));
+
+        // all tasks which have the same name are erased (the hidden ones are not indexed)
+        const TaskHandle<> b2 = Tasks.add("b", [] {});
+        CHECK(Tasks.erase("b"));
+        CHECK(!Tasks.isValid(b));
+        CHECK(!Tasks.isValid(b2));
+        CHECK(!Tasks.exists("b"));
+        CHECK(Tasks.empty());
+    }
+
+    return check::result("handles");
+}
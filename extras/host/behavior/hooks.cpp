@@ -0,0 +1,131 @@
+// enter(), exit() and idle() are called only if the task type (or one of its bases) overrides them:
+// the profiler counts no enter/exit calls for tasks without the hooks, and a stopped task without idle()
+// is not updated at all, while tasks with the hooks (also inherited ones) get every call.
+//
+//   usage: taskmanager_hooks
+
+#define TASKMANAGER_PROFILER_ENABLE
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    struct Counts {
+        int begin {0};
+        int enter {0};
+        int update {0};
+        int exit {0};
+        int idle {0};
+    };
+
+    class Plain : public Task::Base {
+        Counts& counts;
+
+    public:
+        Plain(const String& name, Counts& counts) : Base(name), counts(counts) {}
+        virtual void update() override {
+            ++counts.update;
+        }
+    };
+
+    class Hooked : public Task::Base {
+        Counts& counts;
+
+    public:
+        Hooked(const String& name, Counts& counts) : Base(name), counts(counts) {}
+        virtual void begin() override {
+            ++counts.begin;
+        }
+        virtual void enter() override {
+            ++counts.enter;
+        }
+        virtual void update() override {
+            ++counts.update;
+        }
+        virtual void exit() override {
+            ++counts.exit;
+        }
+        virtual void idle() override {
+            ++counts.idle;
+        }
+    };
+
+    // the hooks are inherited from Hooked
+    class Derived : public Hooked {
+    public:
+        Derived(const String& name, Counts& counts) : Hooked(name, counts) {}
+    };
+
+    void update_for(const uint32_t usec) {
+        for (uint32_t i = 0; i < usec / 1000; ++i) {
+            arduino_shim::advanceUsec(1000);
+            Tasks.update();
+        }
+    }
+
+    void run(const Task::SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        Counts plain_counts, hooked_counts, derived_counts;
+        auto plain = Tasks.add<Plain>("plain", plain_counts);
+        auto hooked = Tasks.add<Hooked>("hooked", hooked_counts);
+        auto derived = Tasks.add<Derived>("derived", derived_counts);
+        CHECK(hooked_counts.begin == 1);
+        CHECK(derived_counts.begin == 1);
+
+        plain->startFps(100.);
+        hooked->startFps(100.);
+        derived->startFps(100.);
+        Tasks.update();
+        update_for(100000);
+        CHECK(plain_counts.update == 11);
+        CHECK(hooked_counts.update == 11);
+        CHECK(derived_counts.update == 11);
+        CHECK((hooked_counts.enter == 1) && (derived_counts.enter == 1));
+        CHECK(plain->getProfile().enter_calls == 0);
+        CHECK(hooked->getProfile().enter_calls == 1);
+        CHECK(derived->getProfile().enter_calls == 1);
+
+        plain->stop();
+        hooked->stop();
+        derived->stop();
+        Tasks.update();
+        CHECK((hooked_counts.exit == 1) && (derived_counts.exit == 1));
+        CHECK(plain->getProfile().exit_calls == 0);
+        CHECK(hooked->getProfile().exit_calls == 1);
+        CHECK(derived->getProfile().exit_calls == 1);
+
+        // stopped: idle() in every update(), or nothing at all without idle()
+        const uint32_t plain_calls = plain->getProfile().recursive_calls;
+        const uint32_t hooked_calls = hooked->getProfile().recursive_calls;
+        const int hooked_idle = hooked_counts.idle;
+        const int derived_idle = derived_counts.idle;
+        update_for(10000);
+        CHECK(plain->getProfile().recursive_calls == plain_calls);
+        CHECK(hooked->getProfile().recursive_calls == hooked_calls + 10);
+        CHECK(hooked_counts.idle == hooked_idle + 10);
+        CHECK(derived_counts.idle == derived_idle + 10);
+        CHECK((plain_counts.update == 11) && (hooked_counts.update == 11) && (derived_counts.update == 11));
+
+        // hooks are called again after restart from stop
+        plain->startFps(100.);
+        hooked->startFps(100.);
+        Tasks.update();
+        CHECK(plain_counts.update == 12);
+        CHECK(hooked_counts.enter == 2);
+        CHECK(plain->getProfile().enter_calls == 0);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    run(Task::SchedulerMode::LINEAR);
+    run(Task::SchedulerMode::DEADLINE);
+
+    return check::result("hooks");
+}
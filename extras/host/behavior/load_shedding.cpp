@@ -0,0 +1,112 @@
+// Under overload, setLoadShedding() must lower the frame rate of adaptive tasks of the lowest priority first
+// (never below min_fps, never non-adaptive tasks), and restore the preferred frame rate when the load drops
+// (highest priority first) or when load shedding is disabled. frame() stays continuous across the changes.
+//
+//   usage: taskmanager_load_shedding
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    // update() takes cost_us of virtual time
+    class Load : public Task::Base {
+    public:
+        uint32_t cost_us;
+
+        Load(const String& name, const uint32_t cost_us) : Base(name), cost_us(cost_us) {}
+
+        virtual void update() override {
+            delayMicroseconds(cost_us);
+        }
+    };
+
+    // update() in virtual time: the clock moves by the cost of tasks and up to 1 ms while idle
+    void run_usec(const int64_t us) {
+        const int64_t end = (int64_t)arduino_shim::elapsed_usec64() + us;
+        while ((int64_t)arduino_shim::elapsed_usec64() < end) {
+            Tasks.update();
+            const int64_t due = Tasks.nextDeadlineUsec();
+            arduino_shim::advanceUsec((due > 0) ? ((due < 1000) ? (uint32_t)due : 1000) : 1);
+        }
+    }
+
+    bool is_fps(Task::Base* t, const float fps) {
+        return (t->getFrameRate() > fps * 0.999f) && (t->getFrameRate() < fps * 1.001f);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    Tasks.setLoadShedding(true, 0.9f, 0.6f, 100);
+
+    // 3 tasks at 100 fps which take 4 ms each: load 1.2
+    auto ui = Tasks.add<Load>("ui", 4000);
+    auto dsp = Tasks.add<Load>("dsp", 4000);
+    auto net = Tasks.add<Load>("net", 4000);
+    ui->setAdaptiveFps(100, 10)->startFps(100);
+    dsp->setPriority(10)->setAdaptiveFps(100, 50)->startFps(100);
+    net->setPriority(5)->startFps(100);  // not adaptive
+
+    // the lowest priority is degraded enough
+    run_usec(3000000);
+    CHECK(Tasks.getLoad() <= 0.9f);
+    CHECK(ui->isDegraded());
+    CHECK(!dsp->isDegraded());
+    CHECK(is_fps(net.get(), 100));
+    CHECK(Tasks.getLoadStats().overloaded > 0);
+    CHECK(Tasks.getLoadStats().degraded > 0);
+    CHECK(Tasks.getLoadStats().restored == 0);
+
+    // lighter load: back to the preferred frame rate
+    ui->cost_us = 100;
+    dsp->cost_us = 100;
+    net->cost_us = 100;
+    run_usec(5000000);
+    CHECK(!ui->isDegraded());
+    CHECK(is_fps(ui.get(), 100));
+    CHECK(Tasks.getLoadStats().restored > 0);
+
+    // heavier: the lowest priority reaches min_fps, then the next one is degraded
+    ui->cost_us = 8000;
+    dsp->cost_us = 8000;
+    run_usec(5000000);
+    CHECK(is_fps(ui.get(), 10));
+    CHECK(dsp->isDegraded());
+    CHECK(dsp->getFrameRate() >= 49.9f);
+    CHECK(is_fps(net.get(), 100));
+
+    // lighter load: the highest priority is restored first
+    ui->cost_us = 100;
+    dsp->cost_us = 100;
+    while (dsp->isDegraded()) {
+        CHECK(ui->getFrameRate() < 10.1f);
+        run_usec(100000);
+    }
+    CHECK(is_fps(dsp.get(), 100));
+    run_usec(5000000);
+    CHECK(is_fps(ui.get(), 100));
+
+    // disabled: all tasks are restored at once
+    ui->cost_us = 8000;
+    dsp->cost_us = 8000;
+    run_usec(3000000);
+    CHECK(ui->isDegraded());
+    Tasks.setLoadShedding(false);
+    CHECK(!ui->isDegraded() && !dsp->isDegraded());
+    CHECK(is_fps(ui.get(), 100) && is_fps(dsp.get(), 100));
+
+    // frame() is continuous when the frame rate is changed
+    auto f = Tasks.add<Load>("f", 0);
+    f->startFps(100);
+    run_usec(1005000);
+    const double frame = f->frame();
+    f->changeFrameRate(50);
+    CHECK(f->frame() == frame);
+
+    return check::result("load_shedding");
+}
@@ -0,0 +1,95 @@
+// Frames missed while update() was not called must be handled by the OverrunPolicy of each task:
+// SKIP and REPHASE run one update() (REPHASE also restarts the frame timing from now), CATCH_UP runs the
+// missed ones up to the limit, and getMissedFrames() / getCoalescedFrames() count them (saturated).
+//
+//   usage: taskmanager_overrun
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    class Counter : public Task::Base {
+    public:
+        uint32_t updates {0};
+        uint32_t last_frame {0};
+
+        Counter(const String& name) : Base(name) {}
+
+        virtual void update() override {
+            ++updates;
+            last_frame = (uint32_t)frame();
+        }
+    };
+
+    void run(const Task::SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        auto skip = Tasks.add<Counter>("skip");
+        auto catch_up = Tasks.add<Counter>("catch_up");
+        auto limited = Tasks.add<Counter>("limited");
+        auto rephase = Tasks.add<Counter>("rephase");
+        catch_up->setOverrunPolicy(Task::OverrunPolicy::CATCH_UP, 8);
+        limited->setOverrunPolicy(Task::OverrunPolicy::CATCH_UP, 2);
+        rephase->setOverrunPolicy(Task::OverrunPolicy::REPHASE);
+        CHECK(skip->getOverrunPolicy() == Task::OverrunPolicy::SKIP);
+        Tasks.startFps(100.);  // every 10 ms
+
+        // frame 0 on time
+        Tasks.update();
+        CHECK(skip->updates == 1);
+        CHECK(skip->getMissedFrames() == 0);
+
+        // frames 1, 2 and 3 are missed (frame 4 is due at 40 ms)
+        arduino_shim::advanceUsec(45000);
+        Tasks.update();
+        CHECK(skip->updates == 2);
+        CHECK(skip->getMissedFrames() == 3);
+        CHECK(skip->getCoalescedFrames() == 3);
+        CHECK(catch_up->updates == 5);
+        CHECK(catch_up->last_frame == 4);
+        CHECK(catch_up->getMissedFrames() == 3);
+        CHECK(catch_up->getCoalescedFrames() == 0);
+        CHECK(limited->updates == 4);
+        CHECK(limited->getMissedFrames() == 3);
+        CHECK(limited->getCoalescedFrames() == 1);
+        CHECK(rephase->updates == 2);
+        CHECK(rephase->getMissedFrames() == 3);
+        CHECK(rephase->getCoalescedFrames() == 3);
+
+        // frame 5 is at 50 ms, but the next frame of rephase is at 55 ms
+        arduino_shim::advanceUsec(5000);
+        Tasks.update();
+        CHECK(skip->updates == 3);
+        CHECK(skip->getMissedFrames() == 3);
+        CHECK(rephase->updates == 2);
+        arduino_shim::advanceUsec(5000);
+        Tasks.update();
+        CHECK(rephase->updates == 3);
+        CHECK(rephase->getMissedFrames() == 3);
+
+        // counters saturate
+        skip->resetOverrunCounts();
+        CHECK(skip->getMissedFrames() == 0);
+        CHECK(skip->getCoalescedFrames() == 0);
+        const uint32_t updates = catch_up->updates;
+        arduino_shim::advanceUsec(700000000);  // 70000 frames
+        Tasks.update();
+        CHECK(skip->getMissedFrames() == 0xFFFF);
+        CHECK(skip->getCoalescedFrames() == 0xFFFF);
+        CHECK(catch_up->updates == updates + 9);
+        CHECK(catch_up->getMissedFrames() == 0xFFFF);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    run(Task::SchedulerMode::LINEAR);
+    run(Task::SchedulerMode::DEADLINE);
+
+    return check::result("overrun");
+}
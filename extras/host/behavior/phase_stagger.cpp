@@ -0,0 +1,94 @@
+// With Tasks.setPhaseStagger(true), tasks started at the same time with the same rate must get
+// their first frames spread evenly across the interval, and keep running at the configured rate.
+// Tasks started with stagger disabled must still run together.
+//
+//   usage: taskmanager_phase_stagger
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "check.h"
+
+namespace {
+
+    constexpr size_t NUM_TASKS = 4;
+    constexpr uint32_t INTERVAL_US = 10000;  // 100 fps
+    constexpr uint32_t STEP_US = 100;
+
+    class Recorder : public Task::Base {
+    public:
+        int updates {0};
+        uint32_t first_us {0};
+
+        Recorder(const String& name) : Base(name) {}
+        virtual void update() override {
+            if (updates++ == 0) first_us = micros();
+        }
+    };
+
+    // first update() of each task (relative to start_us), sorted
+    std::vector<uint32_t> start_and_record(const uint32_t start_us, std::vector<Recorder*>& recorders) {
+        recorders.clear();
+        for (size_t i = 0; i < NUM_TASKS; ++i) {
+            auto t = Tasks.add<Recorder>(String("task") + String((unsigned long)i));
+            recorders.push_back(t.get());
+        }
+        for (auto* r : recorders) r->startFps(1000000. / INTERVAL_US);
+
+        for (uint32_t us = 0; us < INTERVAL_US; us += STEP_US) {
+            Tasks.update();
+            arduino_shim::advanceUsec(STEP_US);
+        }
+        std::vector<uint32_t> firsts;
+        for (auto* r : recorders) {
+            CHECK(r->updates == 1);
+            firsts.push_back(r->first_us - start_us);
+        }
+        std::sort(firsts.begin(), firsts.end());
+        return firsts;
+    }
+
+    void run(const Task::SchedulerMode mode) {
+        std::vector<Recorder*> recorders;
+
+        // without stagger: all tasks run in the first update()
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        Tasks.setPhaseStagger(false);
+        std::vector<uint32_t> firsts = start_and_record(micros(), recorders);
+        CHECK(firsts.front() == 0);
+        CHECK(firsts.back() == 0);
+
+        // with stagger: one task in every quarter of the interval
+        Tasks.clear();
+        Tasks.setPhaseStagger(true);
+        firsts = start_and_record(micros(), recorders);
+        for (size_t i = 0; i < NUM_TASKS; ++i) CHECK(firsts[i] == i * (INTERVAL_US / NUM_TASKS));
+
+        // the rate is not changed: one frame per interval from the first one
+        for (auto* r : recorders) {
+            CHECK(r->getFrameRate() == 1000000. / INTERVAL_US);
+            r->updates = 0;
+        }
+        for (uint32_t us = 0; us < 100 * INTERVAL_US; us += STEP_US) {
+            Tasks.update();
+            arduino_shim::advanceUsec(STEP_US);
+        }
+        for (auto* r : recorders) CHECK(r->updates == 100);
+
+        Tasks.setPhaseStagger(false);
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    run(Task::SchedulerMode::LINEAR);
+    run(Task::SchedulerMode::DEADLINE);
+
+    return check::result("phase_stagger");
+}
@@ -0,0 +1,99 @@
+// With TASKMANAGER_POOL_SIZE, tasks and the containers of the Manager are allocated from the static arena:
+// the blocks of erased tasks must be reused by the next add(), highWaterMark() must be the peak of usedBytes(),
+// and blocks which are larger than the largest size class or don't fit anymore must fall back to the heap.
+// taskmanager_pool is built with TASKMANAGER_POOL_SIZE (see CMakeLists.txt).
+//
+//   usage: taskmanager_pool
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+#ifndef TASKMANAGER_POOL_SIZE
+#error "taskmanager_pool should be built with TASKMANAGER_POOL_SIZE"
+#endif
+
+namespace {
+
+    int updates = 0;
+
+    // larger than the largest size class of the pool (16384 bytes)
+    class Big : public Task::Base {
+        uint8_t data[20000];
+
+    public:
+        Big(const String& name) : Base(name) {}
+        virtual void update() override {
+            data[updates % sizeof(data)] = 1;
+            ++updates;
+        }
+    };
+
+    String name_of(const size_t i) {
+        return String("task") + String((unsigned long)i);
+    }
+
+}  // namespace
+
+int main() {
+    using Task::Pool;
+
+    Tasks.reserve(64);  // containers are not reallocated below
+
+    // the first add() carves new blocks, and erase() returns them to the free lists
+    Tasks.add("a", [] { ++updates; })->startFps(1000.);
+    Tasks.erase("a");
+    const size_t carved = Pool::carvedBytes();
+    const size_t used = Pool::usedBytes();
+    CHECK(carved <= Pool::capacity());
+    CHECK(Pool::fallbacks() == 0);
+
+    // same task again: only the recycled blocks are used
+    for (int i = 0; i < 10; ++i) {
+        Tasks.add("b", [] { ++updates; })->startFps(1000.);
+        CHECK(Pool::usedBytes() > used);
+        Tasks.erase("b");
+        CHECK(Pool::usedBytes() == used);
+    }
+    CHECK(Pool::carvedBytes() == carved);
+    CHECK(Pool::fallbacks() == 0);
+
+    // the high water mark is the peak of used bytes, and it is kept after erase()
+    for (size_t i = 0; i < 4; ++i) Tasks.add(name_of(i), [] { ++updates; })->startFps(1000.);
+    const size_t peak = Pool::usedBytes();
+    CHECK(Pool::highWaterMark() == peak);
+    Tasks.clear();
+    CHECK(Pool::usedBytes() < peak);
+    CHECK(Pool::highWaterMark() == peak);
+    CHECK(Pool::fallbacks() == 0);
+
+    // oversize: from the heap (and back to the heap by erase())
+    const size_t used_before_big = Pool::usedBytes();
+    auto big = Tasks.add<Big>("big");
+    big->startFps(1000.);
+    CHECK(Pool::fallbacks() == 1);
+    updates = 0;
+    Tasks.update();
+    CHECK(updates == 1);
+    Tasks.erase("big");
+    CHECK(Pool::usedBytes() == used_before_big);
+
+    // exhausted: the tasks which don't fit come from the heap and work as the others
+    size_t n = 0;
+    while ((Pool::fallbacks() == 1) && (n < 64)) {
+        Tasks.add(name_of(n), [] { ++updates; })->startFps(1000.);
+        ++n;
+    }
+    CHECK(Pool::fallbacks() > 1);
+    CHECK(Pool::carvedBytes() <= Pool::capacity());
+    CHECK(Pool::highWaterMark() <= Pool::capacity());
+    updates = 0;
+    Tasks.update();
+    CHECK(updates == (int)n);
+    Tasks.clear();
+    CHECK(Pool::usedBytes() == used_before_big);
+
+    Pool::printStats(Serial);
+    return check::result("pool");
+}
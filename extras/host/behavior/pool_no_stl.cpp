@@ -0,0 +1,10 @@
+// TASKMANAGER_POOL_SIZE must be rejected by #error on the boards without libstdc++ (NO-STL):
+// this file is expected not to compile, and the pool_no_stl test checks the message of the #error.
+//
+//   cmake --build build-host --target taskmanager_pool_no_stl  # fails
+
+#include <TaskManager/TaskPool.h>
+
+int main() {
+    return 0;
+}
@@ -0,0 +1,39 @@
+// The profiler reports the lateness of update() from the scheduled time of its frame.
+// Frames which run on time (virtual time, no cost) must have no lateness even with fractional intervals,
+// and a frame which runs late must report the delay.
+//
+//   usage: taskmanager_profiler_lateness
+
+#define TASKMANAGER_PROFILER_ENABLE
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    auto fps10 = Tasks.add("fps10", [] {});
+    auto fps30 = Tasks.add("fps30", [] {});
+    fps10->startFps(10.);
+    fps30->startFps(30.);
+
+    // every frame runs exactly at its time
+    Tasks.simulate((int64_t)arduino_shim::elapsed_usec64() + 60 * 1000000LL, arduino_shim::advanceUsec);
+    CHECK(fps10->getProfile().calls == 601);
+    CHECK(fps30->getProfile().calls >= 1800);  // the last frame is at 60 s + 1 us
+    CHECK(fps10->getProfile().maxLatenessUsec() == 0);
+    CHECK(fps30->getProfile().maxLatenessUsec() == 0);
+
+    // the next frame of fps10 runs 30 ms late
+    fps30->stop();
+    Tasks.update();
+    Tasks.stats().reset();
+    arduino_shim::advanceUsec((uint32_t)Tasks.nextDeadlineUsec() + 30000);
+    Tasks.update();
+    CHECK(fps10->getProfile().calls == 1);
+    CHECK(fps10->getProfile().maxLatenessUsec() == 30000);
+
+    return check::result("profiler_lateness");
+}
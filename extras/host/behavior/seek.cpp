@@ -0,0 +1,115 @@
+// seekSec() of a SEQUENCE must run the step at the time with the time elapsed from its beginning:
+// it exits the current step and enters the target (not if the target is the current step),
+// clamps the time to the sequence, and the sequence goes on from there.
+//
+//   usage: taskmanager_seek
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    String events;
+
+    class Step : public Task::Base {
+    public:
+        char id {'?'};
+
+        Step(const String& name) : Base(name) {}
+
+        virtual void enter() override {
+            events += '+';
+            events += id;
+        }
+        virtual void update() override {}
+        virtual void exit() override {
+            events += '-';
+            events += id;
+        }
+    };
+
+    // the clock runs in real time: the time of a step is checked with a margin
+    bool near_usec(const int64_t us, const int64_t expected) {
+        return (us >= expected) && (us < expected + 20000);
+    }
+
+    void run_usec(const int64_t us) {
+        const int64_t end = (int64_t)arduino_shim::elapsed_usec64() + us;
+        while ((int64_t)arduino_shim::elapsed_usec64() < end) {
+            Tasks.update();
+            delayMicroseconds(500);
+        }
+    }
+
+}  // namespace
+
+int main() {
+    auto main_task = Tasks.add("main", [] {});
+    main_task->then<Step>("s0", 1., [](TaskRef<Step> t) { t->id = '0'; })
+        ->then<Step>("s1", 1., [](TaskRef<Step> t) { t->id = '1'; })
+        ->then<Step>("s2", 1., [](TaskRef<Step> t) { t->id = '2'; });
+    auto s0 = main_task->getSubTaskByName<Step>("s0");
+    auto s1 = main_task->getSubTaskByName<Step>("s1");
+    auto s2 = main_task->getSubTaskByName<Step>("s2");
+    CHECK(main_task->getSequenceDurationSec() == 3.);
+
+    // not running
+    CHECK(!main_task->seekSec(1.));
+
+    main_task->startFps(100.);
+    Tasks.update();
+    CHECK(events == "+0");
+
+    // to another step
+    events = "";
+    CHECK(main_task->seekSec(1.5));
+    CHECK(events == "-0+1");
+    CHECK(main_task->getSubTaskIndex() == 1);
+    CHECK(near_usec(s1->usec64(), 500000));
+    CHECK(near_usec(main_task->usec64(), 1500000));
+
+    // in the current step
+    events = "";
+    CHECK(main_task->seekSec(1.8));
+    CHECK(events == "");
+    CHECK(near_usec(s1->usec64(), 800000));
+
+    // backward
+    CHECK(main_task->seekMsec(250.));
+    CHECK(events == "-1+0");
+    CHECK(main_task->getSubTaskIndex() == 0);
+    CHECK(near_usec(s0->usec64(), 250000));
+
+    // clamped to the sequence
+    events = "";
+    CHECK(main_task->seekUsec64(-5));
+    CHECK(events == "");
+    CHECK(near_usec(s0->usec64(), 0));
+    CHECK(main_task->seekSec(10.));
+    CHECK(events == "-0+2");
+    CHECK(main_task->getSubTaskIndex() == 2);
+    CHECK(s2->usec64() >= 999999);  // at the end of the last step
+
+    // the sequence goes on from the time
+    events = "";
+    CHECK(main_task->seekSec(0.9));
+    run_usec(200000);
+    CHECK(events == "-2+0-0+1");
+    CHECK(main_task->getSubTaskIndex() == 1);
+    CHECK(near_usec(s1->usec64(), 100000));
+
+    // only for SEQUENCE whose steps all have duration
+    auto sync = Tasks.add("sync", [] {});
+    sync->sync<Step>("a", [](TaskRef<Step>) {});
+    sync->startFps(100.);
+    CHECK(!sync->seekSec(0.));
+    auto manual = Tasks.add("manual", [] {});
+    manual->then<Step>("a", 1., [](TaskRef<Step>) {})->then<Step>("b", [](TaskRef<Step>) {});
+    manual->startFps(100.);
+    CHECK(manual->getSequenceDurationSec() == 0.);
+    CHECK(!manual->seekSec(0.));
+
+    return check::result("seek");
+}
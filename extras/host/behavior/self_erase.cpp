@@ -0,0 +1,131 @@
+// A task which erases itself in update() must not be touched after update() returns,
+// even if its slot is reused by a task added in the same update().
+// taskmanager_self_erase_unique is the same test with TASKMANAGER_UNIQUE_OWNERSHIP
+// (Ref is a non-owning pointer: the erased task must be deleted after update() returns).
+//
+//   usage: taskmanager_self_erase
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    int updates = 0;
+
+    class Eraser : public Task::Base {
+        const bool b_replace;
+
+    public:
+        Eraser(const String& name, const bool b_replace = false) : Base(name), b_replace(b_replace) {}
+        virtual void update() override {
+            ++updates;
+            // members are not touched after erase() (the task may already be freed)
+            const String name = getName();
+            const bool b_add = b_replace;
+            Tasks.erase(name);
+            // the erased slot is reused by this task
+            if (b_add) Tasks.add(name + "_next", [] {})->setAutoErase(true)->startFpsForFrame(1000., 1);
+        }
+    };
+
+    int exits = 0;
+
+    class Next : public Task::Base {
+    public:
+        Next(const String& name) : Base(name) {}
+        virtual void update() override {}
+        virtual void exit() override {
+            ++exits;
+        }
+    };
+
+    // stops and erases itself, then the slot is reused by a task which has already been stopped:
+    // the state of this task must not be applied to the new one (e.g. auto-erase before its exit())
+    class Replacer : public Task::Base {
+    public:
+        Replacer(const String& name) : Base(name) {}
+        virtual void update() override {
+            ++updates;
+            const String name = getName();
+            stop();
+            Tasks.erase(name);
+            auto next = Tasks.add<Next>(name + "_next");
+            next->setAutoErase(true);
+            next->startFps(1000.);
+            next->stop();
+        }
+    };
+
+    void start(const bool b_replace) {
+        Tasks.clear();
+        Tasks.add<Eraser>("eraser", b_replace)->setAutoErase(true)->startFps(1000.);
+    }
+
+    void update(const bool b_budget) {
+        if (b_budget)
+            Tasks.updateWithBudget(1000000);
+        else
+            Tasks.update();
+    }
+
+}  // namespace
+
+int main() {
+    arduino_shim::useVirtualClock();
+
+    for (const bool b_replace : {false, true}) {
+        // Tasks.update() in both scheduler modes
+        for (const auto mode : {Task::SchedulerMode::LINEAR, Task::SchedulerMode::DEADLINE}) {
+            Tasks.setSchedulerMode(mode);
+            start(b_replace);
+            updates = 0;
+            Tasks.update();
+            CHECK(updates == 1);
+            CHECK(!Tasks.exists("eraser"));
+            CHECK(Tasks.exists("eraser_next") == b_replace);
+            Tasks.update();
+        }
+        Tasks.setSchedulerMode(Task::SchedulerMode::LINEAR);
+
+        // Tasks.update(name), Tasks.update(index) and Tasks.update(handle)
+        start(b_replace);
+        Tasks.update("eraser");
+        CHECK(!Tasks.exists("eraser"));
+
+        start(b_replace);
+        Tasks.update((size_t)Tasks.getHandle("eraser").getSlot());
+        CHECK(!Tasks.exists("eraser"));
+
+        start(b_replace);
+        const auto h = Tasks.getHandle("eraser");
+        Tasks.update(h);
+        CHECK(!Tasks.exists("eraser"));
+        CHECK(!Tasks.isValid(h));
+        Tasks.update(h);  // stale handle: nothing happens
+    }
+    CHECK(Tasks.size() <= 1);
+
+    // replaced by a new task in the same update(), with and without the budget
+    for (const bool b_budget : {false, true}) {
+        for (const auto mode : {Task::SchedulerMode::LINEAR, Task::SchedulerMode::DEADLINE}) {
+            Tasks.setSchedulerMode(mode);
+            Tasks.clear();
+            Tasks.add<Replacer>("replacer")->setAutoErase(true)->startFps(1000.);
+            updates = 0;
+            exits = 0;
+            update(b_budget);
+            CHECK(updates == 1);
+            CHECK(!Tasks.exists("replacer"));
+            CHECK(Tasks.exists("replacer_next"));
+            CHECK(exits == 0);
+            update(b_budget);
+            CHECK(exits == 1);
+            CHECK(!Tasks.exists("replacer_next"));
+        }
+    }
+    Tasks.setSchedulerMode(Task::SchedulerMode::LINEAR);
+
+    return check::result("self_erase");
+}
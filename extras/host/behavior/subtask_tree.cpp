@@ -0,0 +1,97 @@
+// Nested subtasks must be entered and updated in pre-order (parent first) and exited in post-order
+// (children first), only the current step of a SEQUENCE runs (and exits if the parent is stopped),
+// and a subtask added in a callback joins the tree from the next update().
+//
+//   usage: taskmanager_subtask_tree
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include "check.h"
+
+namespace {
+
+    String events;
+    TaskRef<Task::Base> b;
+    bool b_spawn = false;
+
+    class Node : public Task::Base {
+    public:
+        Node(const String& name) : Base(name) {}
+
+        virtual void enter() override {
+            events += "+" + getName() + " ";
+        }
+        virtual void update() override {
+            events += getName() + " ";
+            // add a sibling which comes after this in the tree
+            if (b_spawn && (getName() == "b1")) {
+                b_spawn = false;
+                b->subtask<Node>("b2", [](TaskRef<Node> t) { t->startFps(10.); });
+            }
+        }
+        virtual void exit() override {
+            events += "-" + getName() + " ";
+        }
+    };
+
+    void setup_sequence(TaskRef<Node> t) {
+        t->then<Node>("a1", 1., [](TaskRef<Node>) {})->then<Node>("a2", 1., [](TaskRef<Node>) {});
+    }
+    void setup_parallel(TaskRef<Node> t) {
+        t->subtask<Node>("b1", [](TaskRef<Node> t) { t->startFps(10.); });
+    }
+
+    // the clock runs in real time: the tree is updated in the middle of frames (10 fps)
+    void wait_until_usec(const int64_t origin_us, const int64_t us) {
+        while ((int64_t)arduino_shim::elapsed_usec64() < origin_us + us) delayMicroseconds(500);
+    }
+
+}  // namespace
+
+int main() {
+    const int64_t origin_us = (int64_t)arduino_shim::elapsed_usec64();
+
+    //   main (SYNC)
+    //   +- a (SEQUENCE)
+    //   |  +- a1 (1 s)
+    //   |  +- a2 (1 s)
+    //   +- b (PARALLEL)
+    //      +- b1 (10 fps)
+    auto root = Tasks.add<Node>("main");
+    root->sync<Node>("a", setup_sequence)->sync<Node>("b", setup_parallel);
+    root->startFps(10.);
+
+    Tasks.update();
+    CHECK(events == "+main +a +a1 +b main a a1 b +b1 b1 ");
+
+    // the next step of the sequence
+    events = "";
+    wait_until_usec(origin_us, 1050000);
+    Tasks.update();
+    CHECK(events == "main a -a1 +a2 b b1 ");  // a1 has no frame at its end (1 s)
+    events = "";
+    wait_until_usec(origin_us, 1150000);
+    Tasks.update();
+    CHECK(events == "main a a2 b b1 ");
+
+    // added in a callback: from the next update()
+    b = root->getSubTaskByName("b");
+    b_spawn = true;
+    events = "";
+    wait_until_usec(origin_us, 1250000);
+    Tasks.update();
+    CHECK(events == "main a a2 b b1 ");
+    events = "";
+    wait_until_usec(origin_us, 1350000);
+    Tasks.update();
+    CHECK(events == "main a a2 b b1 +b2 b2 ");
+
+    // stopped in the middle of the sequence: the current step exits
+    events = "";
+    root->stop();
+    Tasks.update();
+    CHECK(events == "-a2 -a -b1 -b2 -b -main ");
+
+    return check::result("subtask_tree");
+}
@@ -0,0 +1,554 @@
+// Scheduler benchmarks of TaskManager on a desktop host.
+// Results are printed to stdout as JSON.
+//
+//   usage: taskmanager_bench [--quick] [--max-tasks N]
+//     --quick        fewer iterations (for CI smoke runs)
+//     --max-tasks N  upper bound of the number of tasks (default: 65000)
+
+#define TASKMANAGER_EXECUTOR_ENABLE
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    volatile uint32_t sink = 0;
+
+    class Counter : public Task::Base {
+    public:
+        Counter(const String& name) : Base(name) {}
+        virtual void update() override {
+            sink = sink + 1;
+        }
+    };
+
+    class StaticCounter : public Task::StaticBase {
+    public:
+        void update() {
+            sink = sink + 1;
+        }
+    };
+
+    // CPU-heavy update() for the executor (no shared state between tasks)
+    class Heavy : public Task::Base {
+        uint32_t work;
+        volatile uint32_t result {0};
+
+    public:
+        Heavy(const String& name, const uint32_t work) : Base(name), work(work) {}
+        virtual void update() override {
+            uint32_t x = result;
+            for (uint32_t i = 0; i < work; ++i) x = x * 1664525u + 1013904223u;
+            result = x;
+        }
+    };
+
+    struct Options {
+        bool quick {false};
+        size_t max_tasks {65000};
+    };
+
+    struct Result {
+        std::string bench;
+        std::string variant;
+        std::string scheduler;
+        size_t size;
+        size_t iterations;
+        double ns_per_op;
+        double cpu_ratio;  // CPU time / wall time (negative if not measured)
+    };
+
+    std::vector<Result> results;
+
+    void record(const char* bench, const char* variant, const char* scheduler, const size_t size,
+                const size_t iterations, const double ns_per_op, const double cpu_ratio = -1.) {
+        results.push_back({bench, variant, scheduler, size, iterations, ns_per_op, cpu_ratio});
+    }
+
+    double elapsed_ns(const Clock::time_point& from) {
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - from).count();
+    }
+
+    // keeps total work roughly constant for each size
+    size_t iterations_for(const Options& opt, const size_t ops_per_iteration) {
+        const size_t budget = opt.quick ? 100000 : 4000000;
+        size_t n = budget / (ops_per_iteration ? ops_per_iteration : 1);
+        if (n < 5) n = 5;
+        if (n > 1000000) n = 1000000;
+        return n;
+    }
+
+    std::vector<size_t> task_counts(const Options& opt) {
+        const size_t candidates[] = {10, 100, 1000, 10000, 65000};
+        std::vector<size_t> counts;
+        for (const size_t n : candidates)
+            if (n <= opt.max_tasks) counts.push_back(n);
+        return counts;
+    }
+
+    const char* to_string(const SchedulerMode mode) {
+        return (mode == SchedulerMode::DEADLINE) ? "deadline" : "linear";
+    }
+
+    String task_name(const size_t i) {
+        return String("task") + String((unsigned long)i);
+    }
+
+    void prepare(const SchedulerMode mode) {
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+    }
+
+    // ========== Tasks.update() ==========
+
+    // idle: no task is due (pure scheduler overhead)
+    // due:  every task is due on every update
+    void bench_update(const Options& opt, const SchedulerMode mode, const bool all_due) {
+        for (const size_t n : task_counts(opt)) {
+            prepare(mode);
+            Tasks.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                auto t = Tasks.add<Counter>(task_name(i));
+                if (all_due)
+                    t->startFps(1000000.);
+                else
+                    t->startIntervalSec(3600.);
+            }
+            Tasks.update();  // warm up (first frame)
+
+            const size_t iterations = iterations_for(opt, n);
+            const Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) Tasks.update();
+            const double ns = elapsed_ns(begin);
+
+            record("update", all_due ? "due" : "idle", to_string(mode), n, iterations, ns / iterations);
+        }
+    }
+
+    // event_idle: all tasks are waiting for notify()
+    void bench_update_event_idle(const Options& opt, const SchedulerMode mode) {
+        for (const size_t n : task_counts(opt)) {
+            prepare(mode);
+            Tasks.reserve(n);
+            for (size_t i = 0; i < n; ++i) Tasks.add<Counter>(task_name(i))->startOnEvent();
+            Tasks.update();  // warm up (enter)
+
+            const size_t iterations = iterations_for(opt, n);
+            const Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) Tasks.update();
+            const double ns = elapsed_ns(begin);
+
+            record("update", "event_idle", to_string(mode), n, iterations, ns / iterations);
+        }
+    }
+
+    // stopped: all tasks are stopped and don't override idle()
+    void bench_update_stopped(const Options& opt, const SchedulerMode mode) {
+        for (const size_t n : task_counts(opt)) {
+            prepare(mode);
+            Tasks.reserve(n);
+            for (size_t i = 0; i < n; ++i) Tasks.add<Counter>(task_name(i));
+            Tasks.update();  // warm up
+
+            const size_t iterations = iterations_for(opt, n);
+            const Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) Tasks.update();
+            const double ns = elapsed_ns(begin);
+
+            record("update", "stopped", to_string(mode), n, iterations, ns / iterations);
+        }
+    }
+
+    // same as bench_update() with 10 tasks, but in Task::StaticManager
+    using StaticTable = Task::StaticManager<StaticCounter, StaticCounter, StaticCounter, StaticCounter, StaticCounter,
+                                            StaticCounter, StaticCounter, StaticCounter, StaticCounter, StaticCounter>;
+
+    void bench_update_static(const Options& opt, const bool all_due) {
+        StaticTable table;
+        table.begin();
+        table.forEach([all_due](Task::StaticBase& t) {
+            if (all_due)
+                t.startFps(1000000.);
+            else
+                t.startIntervalSec(3600.);
+        });
+        table.update();  // warm up (first frame)
+
+        const size_t n = StaticTable::size();
+        const size_t iterations = iterations_for(opt, n);
+        const Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) table.update();
+        const double ns = elapsed_ns(begin);
+
+        record("update", all_due ? "due" : "idle", "static", n, iterations, ns / iterations);
+    }
+
+    // ========== add / erase churn ==========
+
+    // add and erase one task while n tasks are resident
+    void bench_churn(const Options& opt, const SchedulerMode mode) {
+        for (const size_t n : task_counts(opt)) {
+            if (n + 1 >= 0xFFFF) continue;  // leave a slot for the churned task
+            prepare(mode);
+            for (size_t i = 0; i < n; ++i) Tasks.add<Counter>(task_name(i))->startIntervalSec(3600.);
+
+            const String name("churn");
+            const size_t iterations = iterations_for(opt, 100);
+            const Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                auto h = Tasks.add<Counter>(name);
+                h->startIntervalSec(3600.);
+                Tasks.erase(h);
+            }
+            const double ns = elapsed_ns(begin);
+
+            record("churn", "add_start_erase", to_string(mode), n, iterations, ns / iterations);
+        }
+    }
+
+    // ========== name lookup ==========
+
+    void bench_lookup(const Options& opt) {
+        for (const size_t n : task_counts(opt)) {
+            prepare(SchedulerMode::LINEAR);
+            std::vector<String> names;
+            names.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                names.push_back(task_name(i));
+                Tasks.add<Counter>(names.back());
+            }
+
+            const size_t iterations = iterations_for(opt, 10);
+            size_t found = 0;
+            Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                // visit names in a scattered order
+                if (Tasks.getTaskByName(names[(i * 7919) % n])) ++found;
+            }
+            double ns = elapsed_ns(begin);
+            record("lookup", "hit", to_string(SchedulerMode::LINEAR), n, iterations, ns / iterations);
+
+            const String missing("missing");
+            begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) found += Tasks.exists(missing);
+            ns = elapsed_ns(begin);
+            record("lookup", "miss", to_string(SchedulerMode::LINEAR), n, iterations, ns / iterations);
+
+            // returned Ref only (shared_ptr copy, or a plain pointer with TASKMANAGER_UNIQUE_OWNERSHIP)
+            begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+                if (Tasks.getTaskByIndex((i * 7919) % n)) ++found;
+            ns = elapsed_ns(begin);
+            record("lookup", "index", to_string(SchedulerMode::LINEAR), n, iterations, ns / iterations);
+
+            if (found != 2 * iterations) fprintf(stderr, "lookup: unexpected result %zu / %zu\n", found, 2 * iterations);
+        }
+    }
+
+    // ========== groups ==========
+
+    // pause() + play() of 10 tasks among n tasks: by name one by one vs by Group
+    void bench_group(const Options& opt) {
+        const size_t members = 10;
+        for (const size_t n : task_counts(opt)) {
+            if (n < members) continue;
+            prepare(SchedulerMode::LINEAR);
+            std::vector<String> names;
+            Task::Group leds = Tasks.group("leds");
+            for (size_t i = 0; i < n; ++i) {
+                auto h = Tasks.add<Counter>(task_name(i));
+                h->startFps(1000.);
+                if (i % (n / members) == 0 && names.size() < members) {
+                    names.push_back(task_name(i));
+                    leds.add(h);
+                }
+            }
+
+            const size_t iterations = iterations_for(opt, members);
+            Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                for (const auto& name : names) Tasks[name]->pause();
+                for (const auto& name : names) Tasks[name]->play();
+            }
+            double ns = elapsed_ns(begin);
+            record("group", "by_name", to_string(SchedulerMode::LINEAR), n, iterations, ns / iterations);
+
+            begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                leds.pause();
+                leds.play();
+            }
+            ns = elapsed_ns(begin);
+            record("group", "group", to_string(SchedulerMode::LINEAR), n, iterations, ns / iterations);
+        }
+    }
+
+    // ========== subtasks ==========
+
+    const size_t subtask_counts[] = {4, 64, 1024};
+
+    // nest PARALLEL subtasks `depth` levels deep
+    void nest(Task::Base* parent, const size_t depth) {
+        if (depth == 0) return;
+        parent->subtask<Counter>(task_name(depth), [depth](TaskRef<Counter> st) {
+            st->startFps(1000000.);
+            nest(st.get(), depth - 1);
+        });
+    }
+
+    // nest SYNC subtasks `depth` levels deep (started by the root)
+    void nest_sync(Task::Base* parent, const size_t depth) {
+        if (depth == 0) return;
+        parent->sync<Counter>(task_name(depth), [depth](TaskRef<Counter> st) { nest_sync(st.get(), depth - 1); });
+    }
+
+    void run_subtasks(const Options& opt, const SchedulerMode mode, const char* variant, const size_t n) {
+        Tasks["root"]->startFps(1000000.);
+        Tasks.update();  // warm up (enter)
+
+        const size_t iterations = iterations_for(opt, n);
+        const Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) Tasks.update();
+        const double ns = elapsed_ns(begin);
+
+        record("subtasks", variant, to_string(mode), n, iterations, ns / iterations);
+    }
+
+    // SYNC and SEQUENCE are flat (one level of n subtasks), *_depth are chains of n levels
+    void bench_subtasks(const Options& opt, const SchedulerMode mode) {
+        for (const size_t n : subtask_counts) {
+            prepare(mode);
+            auto root = Tasks.add<Counter>("root");
+            for (size_t i = 0; i < n; ++i) root->sync<Counter>(task_name(i), [](TaskRef<Counter>) {});
+            run_subtasks(opt, mode, "sync", n);
+
+            prepare(mode);
+            root = Tasks.add<Counter>("root");
+            for (size_t i = 0; i < n; ++i) root->then<Counter>(task_name(i), 1., [](TaskRef<Counter>) {});
+            run_subtasks(opt, mode, "sequence", n);
+
+            prepare(mode);
+            root = Tasks.add<Counter>("root");
+            nest(root.get(), n);
+            run_subtasks(opt, mode, "parallel_depth", n);
+
+            prepare(mode);
+            root = Tasks.add<Counter>("root");
+            nest_sync(root.get(), n);
+            run_subtasks(opt, mode, "sync_depth", n);
+        }
+    }
+
+    // seek to pseudo random times in a SEQUENCE of n steps (1 sec each)
+    void bench_seek(const Options& opt, const SchedulerMode mode) {
+        for (const size_t n : subtask_counts) {
+            prepare(mode);
+            auto root = Tasks.add<Counter>("root");
+            for (size_t i = 0; i < n; ++i) root->then<Counter>(task_name(i), 1., [](TaskRef<Counter>) {});
+            root->startFps(1000000.);
+            Tasks.update();  // warm up (enter)
+
+            const size_t iterations = iterations_for(opt, 100);
+            uint32_t x = 1;
+            const Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                x = x * 1664525u + 1013904223u;
+                root->seekUsec64((int64_t)(x % (uint32_t)n) * 1000000 + 500000);
+            }
+            const double ns = elapsed_ns(begin);
+
+            record("seek", "sequence", to_string(mode), n, iterations, ns / iterations);
+        }
+    }
+
+    // ========== tickless idle ==========
+
+    double cpu_ns() {
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+    }
+
+    void sleep_usec(const uint32_t us) {
+        timespec ts;
+        ts.tv_sec = us / 1000000;
+        ts.tv_nsec = (long)(us % 1000000) * 1000;
+        nanosleep(&ts, nullptr);
+    }
+
+    // n tasks at 100 fps: spin on update() vs updateAndSleep() with nanosleep()
+    // ns_per_op is CPU time per Tasks.update() call
+    void bench_tickless(const Options& opt, const SchedulerMode mode, const bool sleep) {
+        const size_t n = 10;
+        const double fps = 100.;
+        const double wall_sec = opt.quick ? 0.2 : 1.;
+
+        prepare(mode);
+        for (size_t i = 0; i < n; ++i) Tasks.add<Counter>(task_name(i))->startFpsFromSec(fps, 0.001 * i);
+
+        const uint32_t sink_begin = sink;
+        size_t iterations = 0;
+        const double cpu_begin = cpu_ns();
+        const Clock::time_point begin = Clock::now();
+        while (elapsed_ns(begin) < wall_sec * 1e9) {
+            if (sleep)
+                Tasks.updateAndSleep(sleep_usec);
+            else
+                Tasks.update();
+            ++iterations;
+        }
+        const double cpu = cpu_ns() - cpu_begin;
+        const double wall = elapsed_ns(begin);
+
+        // all frames should be updated even if sleeping
+        const double expected = n * fps * wall_sec;
+        const double updated = (double)(uint32_t)(sink - sink_begin);
+        if (updated < expected * 0.9) fprintf(stderr, "tickless: missed frames %.0f / %.0f\n", updated, expected);
+
+        record("tickless", sleep ? "sleep" : "spin", to_string(mode), n, iterations, cpu / iterations, cpu / wall);
+    }
+
+    // ========== phase staggering ==========
+
+    // 32 CPU-heavy tasks started together at 100 fps, with and without Tasks.setPhaseStagger()
+    // ns_per_op is the median of the longest Tasks.update() in each frame (worst-case loop latency,
+    // the median drops the frames in which the bench was preempted by the OS)
+    void bench_stagger(const Options& opt, const SchedulerMode mode, const bool stagger) {
+        const size_t n = 32;
+        const double wall_sec = opt.quick ? 0.2 : 1.;
+
+        prepare(mode);
+        Tasks.setPhaseStagger(stagger);
+        for (size_t i = 0; i < n; ++i) Tasks.add<Heavy>(task_name(i), 20000);
+        Tasks.startFps(100.);
+
+        const double frame_ns = 1e7;
+        std::vector<double> max_ns(1, 0.);
+        size_t iterations = 0;
+        const Clock::time_point begin = Clock::now();
+        for (double now = 0.; now < wall_sec * 1e9; now = elapsed_ns(begin)) {
+            if (now >= frame_ns * max_ns.size()) max_ns.push_back(0.);
+            const Clock::time_point t = Clock::now();
+            Tasks.update();
+            const double ns = elapsed_ns(t);
+            if (ns > max_ns.back()) max_ns.back() = ns;
+            ++iterations;
+        }
+        Tasks.setPhaseStagger(false);
+
+        std::sort(max_ns.begin(), max_ns.end());
+        record("stagger", stagger ? "on" : "off", to_string(mode), n, iterations, max_ns[max_ns.size() / 2]);
+    }
+
+    // ========== executor ==========
+
+    // 64 CPU-heavy tasks due on every update() with 0 (calling thread only) to N workers
+    // size is the number of workers
+    void bench_executor(const Options& opt, const SchedulerMode mode) {
+        const size_t n = 64;
+        const uint32_t work = 20000;
+        size_t max_workers = std::thread::hardware_concurrency();
+        if (max_workers < 1) max_workers = 1;
+
+        std::vector<size_t> workers;
+        for (size_t w = 0; w <= max_workers; w = (w == 0) ? 1 : (w * 2)) workers.push_back(w);
+        if (workers.back() != max_workers) workers.push_back(max_workers);
+
+        for (const size_t w : workers) {
+            prepare(mode);
+            Tasks.setWorkers(w);
+            for (size_t i = 0; i < n; ++i) Tasks.add<Heavy>(task_name(i), work)->startFps(1000000.);
+            Tasks.update();  // warm up (first frame)
+
+            const size_t iterations = opt.quick ? 20 : 200;
+            const Clock::time_point begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) Tasks.update();
+            const double ns = elapsed_ns(begin);
+
+            record("executor", "cpu_heavy", to_string(mode), w, iterations, ns / iterations);
+        }
+        Tasks.setWorkers(0);
+    }
+
+    // ========== output ==========
+
+    void print_json(const Options& opt) {
+        printf("{\n");
+        printf("  \"library\": \"TaskManager\",\n");
+#ifdef __VERSION__
+        printf("  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+        printf("  \"cplusplus\": %ld,\n", (long)__cplusplus);
+        printf("  \"quick\": %s,\n", opt.quick ? "true" : "false");
+        printf("  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            printf(
+                "    {\"bench\": \"%s\", \"variant\": \"%s\", \"scheduler\": \"%s\", \"size\": %zu, "
+                "\"iterations\": %zu, \"ns_per_op\": %.3f",
+                r.bench.c_str(), r.variant.c_str(), r.scheduler.c_str(), r.size, r.iterations, r.ns_per_op);
+            if (r.cpu_ratio >= 0.) printf(", \"cpu_ratio\": %.4f", r.cpu_ratio);
+            printf("}%s\n", (i + 1 < results.size()) ? "," : "");
+        }
+        printf("  ]\n");
+        printf("}\n");
+    }
+
+    bool parse(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], "--quick") == 0) {
+                opt.quick = true;
+            } else if ((strcmp(argv[i], "--max-tasks") == 0) && (i + 1 < argc)) {
+                opt.max_tasks = strtoul(argv[++i], nullptr, 10);
+            } else {
+                fprintf(stderr, "usage: %s [--quick] [--max-tasks N]\n", argv[0]);
+                return false;
+            }
+        }
+        // task slots are 16bit (0xFFFF is reserved for invalid handle)
+        if (opt.max_tasks > 0xFFFE) opt.max_tasks = 0xFFFE;
+        return true;
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse(argc, argv, opt)) return 1;
+
+    const SchedulerMode modes[] = {SchedulerMode::LINEAR, SchedulerMode::DEADLINE};
+    for (const SchedulerMode mode : modes) {
+        bench_update(opt, mode, false);
+        bench_update(opt, mode, true);
+        bench_update_event_idle(opt, mode);
+        bench_update_stopped(opt, mode);
+        bench_churn(opt, mode);
+        bench_subtasks(opt, mode);
+        bench_seek(opt, mode);
+        bench_tickless(opt, mode, false);
+        bench_tickless(opt, mode, true);
+        bench_stagger(opt, mode, false);
+        bench_stagger(opt, mode, true);
+        bench_executor(opt, mode);
+    }
+    bench_update_static(opt, false);
+    bench_update_static(opt, true);
+    bench_lookup(opt);
+    bench_group(opt);
+    Tasks.clear();
+
+    print_json(opt);
+    return 0;
+}
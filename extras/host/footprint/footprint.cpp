@@ -0,0 +1,124 @@
+// RAM footprint of the same task set in Task::StaticManager and in the dynamic Manager (Tasks).
+// Heap usage is measured by replacing the global operator new / delete.
+// Flash usage depends on the target: compare examples/task_static_manager and examples/task_class_simple
+// with the size report of your toolchain (e.g. arduino-cli compile).
+// taskmanager_footprint_unique is the same program built with TASKMANAGER_UNIQUE_OWNERSHIP,
+// and taskmanager_footprint_compact with TASKMANAGER_UNIQUE_OWNERSHIP and TASKMANAGER_NAME_HASH.
+//
+//   usage: taskmanager_footprint
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    size_t heap_bytes = 0;
+    size_t heap_blocks = 0;
+
+    volatile uint32_t sink = 0;
+
+    class StaticCounter : public Task::StaticBase {
+    public:
+        void update() {
+            sink = sink + 1;
+        }
+    };
+
+    class Counter : public Task::Base {
+    public:
+        Counter(const String& name) : Base(name) {}
+        virtual void update() override {
+            sink = sink + 1;
+        }
+    };
+
+    // members of Task::Base other than FrameRateCounter (the subtask containers of leaf tasks are not allocated)
+    static_assert(sizeof(Counter) - sizeof(FrameRateCounter) <= 16 * sizeof(void*), "Task::Base has grown");
+
+    using StaticTable = Task::StaticManager<StaticCounter, StaticCounter, StaticCounter, StaticCounter, StaticCounter,
+                                            StaticCounter, StaticCounter, StaticCounter, StaticCounter, StaticCounter>;
+
+    struct Usage {
+        size_t bytes;
+        size_t blocks;
+    };
+
+    Usage measure_static(size_t& object_bytes) {
+        const size_t bytes = heap_bytes, blocks = heap_blocks;
+        {
+            StaticTable table;
+            table.begin();
+            table.forEach([](Task::StaticBase& t) { t.startFps(1000.); });
+            for (size_t i = 0; i < 10; ++i) table.update();
+            object_bytes = sizeof(table);
+        }
+        return Usage {heap_bytes - bytes, heap_blocks - blocks};
+    }
+
+    Usage measure_dynamic() {
+        Tasks.update();  // construct the Manager before measuring
+        const size_t bytes = heap_bytes, blocks = heap_blocks;
+        for (size_t i = 0; i < StaticTable::size(); ++i)
+            Tasks.add<Counter>(String("task") + String((unsigned long)i))->startFps(1000.);
+        for (size_t i = 0; i < 10; ++i) Tasks.update();
+        const Usage usage {heap_bytes - bytes, heap_blocks - blocks};
+        Tasks.clear();
+        return usage;
+    }
+
+}  // namespace
+
+// count live heap usage (sized delete is not guaranteed, so the size is stored in front of the block)
+// (not inlined into the containers, otherwise GCC warns that free() doesn't match operator new)
+__attribute__((noinline)) void* operator new(size_t n) {
+    size_t* p = static_cast<size_t*>(malloc(n + sizeof(max_align_t)));
+    if (!p) throw std::bad_alloc();
+    *p = n;
+    heap_bytes += n;
+    ++heap_blocks;
+    return reinterpret_cast<uint8_t*>(p) + sizeof(max_align_t);
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (!p) return;
+    size_t* b = reinterpret_cast<size_t*>(static_cast<uint8_t*>(p) - sizeof(max_align_t));
+    heap_bytes -= *b;
+    --heap_blocks;
+    free(b);
+}
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+int main() {
+    size_t static_object_bytes = 0;
+    const Usage s = measure_static(static_object_bytes);
+    const Usage d = measure_dynamic();
+
+    printf("{\n");
+    printf("  \"tasks\": %zu,\n", StaticTable::size());
+#ifdef TASKMANAGER_UNIQUE_OWNERSHIP
+    printf("  \"ownership\": \"unique\",\n");
+#else
+    printf("  \"ownership\": \"shared\",\n");
+#endif
+#ifdef TASKMANAGER_NAME_HASH
+    printf("  \"name\": \"hash\",\n");
+#else
+    printf("  \"name\": \"string\",\n");
+#endif
+    printf("  \"static\": {\"object_bytes\": %zu, \"task_bytes\": %zu, \"heap_bytes\": %zu, \"heap_blocks\": %zu},\n",
+           static_object_bytes, sizeof(StaticCounter), s.bytes, s.blocks);
+    printf(
+        "  \"dynamic\": {\"manager_bytes\": %zu, \"task_bytes\": %zu, \"timer_bytes\": %zu, \"ref_bytes\": %zu, "
+        "\"heap_bytes\": %zu, \"heap_blocks\": %zu}\n",
+        sizeof(Task::Manager), sizeof(Counter), sizeof(FrameRateCounter), sizeof(TaskRef<Task::Base>), d.bytes,
+        d.blocks);
+    printf("}\n");
+
+    // StaticManager must not touch the heap
+    return (s.bytes == 0 && s.blocks == 0) ? 0 : 1;
+}
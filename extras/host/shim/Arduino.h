@@ -0,0 +1,248 @@
+#pragma once
+#ifndef ARDUINO_TASK_MANAGER_HOST_SHIM_ARDUINO_H
+#define ARDUINO_TASK_MANAGER_HOST_SHIM_ARDUINO_H
+
+// Minimal subset of the Arduino core API to build TaskManager on a desktop host.
+// Only what TaskManager and its dependencies use is provided.
+
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// ========== time ==========
+
+namespace arduino_shim {
+    // virtual time for simulation (e.g. Tasks.simulate()): it moves only by advanceUsec() and delay()
+    struct VirtualClock {
+        std::atomic<bool> b_enabled {false};
+        std::atomic<uint64_t> now_us {0};
+    };
+    inline VirtualClock& virtual_clock() {
+        static VirtualClock c;
+        return c;
+    }
+
+    inline uint64_t steady_usec64() {
+        static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin)
+            .count();
+    }
+    inline uint64_t elapsed_usec64() {
+        VirtualClock& c = virtual_clock();
+        return c.b_enabled ? c.now_us.load() : steady_usec64();
+    }
+
+    // switch micros() / millis() to virtual time which starts at from_us
+    inline void useVirtualClock(const uint64_t from_us = 0) {
+        virtual_clock().now_us = from_us;
+        virtual_clock().b_enabled = true;
+    }
+    // back to the steady clock
+    inline void useSteadyClock() {
+        virtual_clock().b_enabled = false;
+    }
+    inline bool isVirtualClock() {
+        return virtual_clock().b_enabled;
+    }
+    inline void advanceUsec(const uint32_t us) {
+        virtual_clock().now_us += us;
+    }
+}  // namespace arduino_shim
+
+// same as Arduino, these wrap around after 2^32 (about 71 min for micros())
+inline unsigned long micros() {
+    return (unsigned long)(uint32_t)arduino_shim::elapsed_usec64();
+}
+inline unsigned long millis() {
+    return (unsigned long)(uint32_t)(arduino_shim::elapsed_usec64() / 1000);
+}
+// with the virtual clock, delays advance the time instead of sleeping
+inline void delay(const unsigned long ms) {
+    if (arduino_shim::isVirtualClock())
+        arduino_shim::advanceUsec((uint32_t)(ms * 1000));
+    else
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+inline void delayMicroseconds(const unsigned int us) {
+    if (arduino_shim::isVirtualClock())
+        arduino_shim::advanceUsec(us);
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+inline void yield() {
+    std::this_thread::yield();
+}
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// ========== GPIO (no-op) ==========
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LED_BUILTIN 13
+
+inline void pinMode(const uint8_t, const uint8_t) {}
+inline void digitalWrite(const uint8_t, const uint8_t) {}
+inline int digitalRead(const uint8_t) {
+    return LOW;
+}
+
+// ========== String ==========
+
+class String {
+    std::string s;
+
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const std::string& str) : s(str) {}
+    String(const char c) : s(1, c) {}
+    String(const int v) : s(std::to_string(v)) {}
+    String(const unsigned int v) : s(std::to_string(v)) {}
+    String(const long v) : s(std::to_string(v)) {}
+    String(const unsigned long v) : s(std::to_string(v)) {}
+    String(const double v, const unsigned int digits = 2) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)digits, v);
+        s = buf;
+    }
+
+    const char* c_str() const {
+        return s.c_str();
+    }
+    unsigned int length() const {
+        return (unsigned int)s.length();
+    }
+    bool reserve(const unsigned int size) {
+        s.reserve(size);
+        return true;
+    }
+    char charAt(const unsigned int i) const {
+        return (i < s.length()) ? s[i] : 0;
+    }
+    char operator[](const unsigned int i) const {
+        return charAt(i);
+    }
+
+    bool concat(const String& str) {
+        s += str.s;
+        return true;
+    }
+    String& operator+=(const String& str) {
+        s += str.s;
+        return *this;
+    }
+    friend String operator+(const String& lhs, const String& rhs) {
+        return String(lhs.s + rhs.s);
+    }
+
+    bool equals(const String& str) const {
+        return s == str.s;
+    }
+    bool operator==(const String& str) const {
+        return s == str.s;
+    }
+    bool operator!=(const String& str) const {
+        return s != str.s;
+    }
+    bool operator<(const String& str) const {
+        return s < str.s;
+    }
+};
+
+// ========== Print / Serial ==========
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(const uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) {
+        return str ? write((const uint8_t*)str, strlen(str)) : 0;
+    }
+
+    size_t print(const char* str) {
+        return write(str);
+    }
+    size_t print(const String& str) {
+        return write(str.c_str());
+    }
+    size_t print(const char c) {
+        return write((uint8_t)c);
+    }
+    size_t print(const int v) {
+        return print((long)v);
+    }
+    size_t print(const unsigned int v) {
+        return print((unsigned long)v);
+    }
+    size_t print(const long v) {
+        return print(String(v));
+    }
+    size_t print(const unsigned long v) {
+        return print(String(v));
+    }
+    size_t print(const long long v) {
+        return print(String(std::to_string(v)));
+    }
+    size_t print(const unsigned long long v) {
+        return print(String(std::to_string(v)));
+    }
+    size_t print(const double v, const int digits = 2) {
+        return print(String(v, (unsigned int)digits));
+    }
+
+    size_t println() {
+        return write("\r\n");
+    }
+    template <typename T>
+    size_t println(const T& v) {
+        size_t n = print(v);
+        return n + println();
+    }
+};
+
+// writes to stdout
+class HardwareSerial : public Print {
+public:
+    void begin(const unsigned long) {}
+    int available() {
+        return 0;
+    }
+    int read() {
+        return -1;
+    }
+    void flush() {
+        fflush(stdout);
+    }
+    virtual size_t write(const uint8_t c) override {
+        return (fputc(c, stdout) == EOF) ? 0 : 1;
+    }
+    virtual size_t write(const uint8_t* buffer, size_t size) override {
+        return fwrite(buffer, 1, size, stdout);
+    }
+    using Print::write;
+    explicit operator bool() const {
+        return true;
+    }
+};
+
+static HardwareSerial Serial;
+
+#endif  // ARDUINO_TASK_MANAGER_HOST_SHIM_ARDUINO_H
@@ -0,0 +1,133 @@
+// Fast-forward a long schedule in virtual time with Tasks.simulate() and the virtual clock of the shim.
+// Every frame must run at its exact time (no lateness in virtual time), frame counts must match the schedule,
+// and the trace of the same schedule must be the same in every run and with both scheduler modes.
+//
+//   usage: taskmanager_simulate [hours]
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+    struct Trace {
+        uint64_t hash {14695981039346656037ULL};  // FNV-1a of (time, task id)
+        uint64_t events {0};
+        int64_t max_late_us {0};
+
+        void add(const int64_t us, const uint32_t id) {
+            const uint64_t v[2] = {(uint64_t)us, id};
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(v);
+            for (size_t i = 0; i < sizeof(v); ++i) hash = (hash ^ p[i]) * 1099511628211ULL;
+            ++events;
+        }
+    };
+
+    Trace* trace = nullptr;
+    int64_t origin_us = 0;
+
+    class Probe : public Task::Base {
+        const uint32_t id;
+
+    public:
+        uint32_t updates {0};
+        uint32_t exits {0};
+
+        Probe(const String& name, const uint32_t id) : Base(name), id(id) {}
+
+        virtual void update() override {
+            const int64_t now = (int64_t)arduino_shim::elapsed_usec64() - origin_us;
+            trace->add(now, id);
+            ++updates;
+            // frame n of a task started at origin should run exactly at ceil(n * interval)
+            const double interval_us = getIntervalSec() * 1000000.;
+            const int64_t due = (int64_t)ceil(frame() * interval_us) + (int64_t)(getOffsetSec() * 1000000.);
+            if (now - due > trace->max_late_us) trace->max_late_us = now - due;
+        }
+        virtual void exit() override {
+            trace->add((int64_t)arduino_shim::elapsed_usec64() - origin_us, id | 0x80000000);
+            ++exits;
+        }
+    };
+
+    struct Result {
+        Trace trace;
+        uint32_t frames, minutes, hours, intro, intro_exits;
+        double wall_ms;
+    };
+
+    Result run(const Task::SchedulerMode mode, const int64_t duration_us) {
+        Result r;
+        trace = &r.trace;
+        Tasks.clear();
+        Tasks.setSchedulerMode(mode);
+        origin_us = (int64_t)arduino_shim::elapsed_usec64();
+
+        auto frames = Tasks.add<Probe>("frames", 1);
+        auto minutes = Tasks.add<Probe>("minutes", 2);
+        auto hours = Tasks.add<Probe>("hours", 3);
+        auto intro = Tasks.add<Probe>("intro", 4);
+        frames->startFps(30.);
+        minutes->startIntervalSec(60.);
+        hours->startIntervalSec(3600.);
+        intro->startFpsForSec(1., 600.);  // the first 10 minutes only
+
+        const auto begin = std::chrono::steady_clock::now();
+        Tasks.simulate(origin_us + duration_us, arduino_shim::advanceUsec);
+        r.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        r.frames = frames->updates;
+        r.minutes = minutes->updates;
+        r.hours = hours->updates;
+        r.intro = intro->updates;
+        r.intro_exits = intro->exits;
+        return r;
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t hours = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 24;
+    const int64_t duration_us = (int64_t)hours * 3600 * 1000000;
+
+    arduino_shim::useVirtualClock();
+    const Result a = run(Task::SchedulerMode::LINEAR, duration_us);
+    const Result b = run(Task::SchedulerMode::LINEAR, duration_us);
+    const Result c = run(Task::SchedulerMode::DEADLINE, duration_us);
+
+    bool ok = true;
+    // the first frame runs at 0 and the last one at the end of the schedule
+    const uint32_t expected_frames = hours * 3600 * 30 + 1;
+    if ((a.frames != expected_frames) || (a.minutes != hours * 60 + 1) || (a.hours != hours + 1)) {
+        fprintf(stderr, "frames %u (expected %u), minutes %u, hours %u\n", a.frames, expected_frames, a.minutes,
+                a.hours);
+        ok = false;
+    }
+    if ((a.intro != 600) || (a.intro_exits != 1)) {
+        fprintf(stderr, "intro: updates %u, exits %u\n", a.intro, a.intro_exits);
+        ok = false;
+    }
+    if (a.trace.max_late_us > 1) {
+        fprintf(stderr, "late by %lld us in virtual time\n", (long long)a.trace.max_late_us);
+        ok = false;
+    }
+    if ((a.trace.hash != b.trace.hash) || (a.trace.events != b.trace.events)) {
+        fprintf(stderr, "trace differs between runs\n");
+        ok = false;
+    }
+    if ((a.frames != c.frames) || (a.minutes != c.minutes) || (a.hours != c.hours) || (a.intro != c.intro) ||
+        (a.trace.events != c.trace.events) || (c.trace.max_late_us > 1)) {
+        fprintf(stderr, "DEADLINE scheduler differs from LINEAR\n");
+        ok = false;
+    }
+
+    printf(
+        "{\"hours\": %u, \"events\": %llu, \"trace\": \"%016llx\", \"max_late_us\": %lld, \"linear_ms\": %.1f, "
+        "\"deadline_ms\": %.1f, \"result\": \"%s\"}\n",
+        hours, (unsigned long long)a.trace.events, (unsigned long long)a.trace.hash, (long long)a.trace.max_late_us,
+        a.wall_ms, c.wall_ms, ok ? "ok" : "failed");
+    return ok ? 0 : 1;
+}
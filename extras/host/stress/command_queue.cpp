@@ -0,0 +1,115 @@
+// Stress test of Tasks.post() with many producer threads and one consumer (Tasks.update()).
+// Every accepted command must be applied exactly once, and every rejected one must be counted as an overflow.
+//
+//   usage: taskmanager_stress_command_queue [producers] [commands_per_producer]
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    class Target : public Task::Base {
+    public:
+        Target(const String& name) : Base(name) {}
+        virtual void update() override {}
+    };
+
+    struct Producer {
+        uint32_t id;
+        uint32_t accepted {0};
+        uint32_t rejected {0};
+        uint32_t applied {0};  // written only by the consumer
+        uint32_t last {0};     // sequence check: commands from one producer are applied in order
+        bool b_ordered {true};
+    };
+
+    struct Call {
+        Producer* producer;
+        uint32_t seq;
+    };
+
+    void on_call(void* arg) {
+        Call* c = static_cast<Call*>(arg);
+        Producer* p = c->producer;
+        if (c->seq <= p->last) p->b_ordered = false;
+        p->last = c->seq;
+        ++p->applied;
+        delete c;
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t num_producers = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 8;
+    const uint32_t num_commands = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 20000;
+
+    std::vector<TaskHandle<Target>> targets;
+    for (size_t i = 0; i < 4; ++i) targets.push_back(Tasks.add<Target>(String("target") + String((unsigned long)i)));
+
+    std::vector<Producer> producers(num_producers);
+    std::atomic<size_t> running {num_producers};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_producers; ++i) {
+        producers[i].id = (uint32_t)i;
+        threads.emplace_back([&, i] {
+            Producer& p = producers[i];
+            for (uint32_t n = 1; n <= num_commands; ++n) {
+                // control tasks as well as calls to check the order and the count
+                const auto& t = targets[n % targets.size()];
+                Tasks.post(t, (n & 1) ? Task::Command::startFps(1000.) : Task::Command::stop());
+
+                Call* c = new Call {&p, n};
+                if (Tasks.post(Task::Command::call(on_call, c))) {
+                    ++p.accepted;
+                } else {
+                    ++p.rejected;
+                    delete c;
+                    std::this_thread::yield();
+                }
+            }
+            --running;
+        });
+    }
+
+    // consumer
+    size_t updates = 0;
+    while (running.load() > 0) {
+        Tasks.update();
+        ++updates;
+    }
+    for (auto& t : threads) t.join();
+    Tasks.update();  // drain the rest
+
+    uint64_t accepted = 0, rejected = 0, applied = 0;
+    bool ok = true;
+    for (const auto& p : producers) {
+        accepted += p.accepted;
+        rejected += p.rejected;
+        applied += p.applied;
+        if ((p.applied != p.accepted) || !p.b_ordered) {
+            fprintf(stderr, "producer %u: accepted %u, applied %u, ordered %d\n", p.id, p.accepted, p.applied,
+                    p.b_ordered);
+            ok = false;
+        }
+    }
+    // task control commands are counted only as overflows
+    const uint64_t overflows = Tasks.getCommandOverflows();
+    if (overflows < rejected) {
+        fprintf(stderr, "overflows %llu < rejected calls %llu\n", (unsigned long long)overflows,
+                (unsigned long long)rejected);
+        ok = false;
+    }
+
+    printf(
+        "{\"producers\": %zu, \"commands_per_producer\": %u, \"accepted_calls\": %llu, \"applied_calls\": %llu, "
+        "\"overflows\": %llu, \"updates\": %zu, \"result\": \"%s\"}\n",
+        num_producers, num_commands, (unsigned long long)accepted, (unsigned long long)applied,
+        (unsigned long long)overflows, updates, ok ? "ok" : "failed");
+    return ok ? 0 : 1;
+}
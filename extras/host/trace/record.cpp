@@ -0,0 +1,128 @@
+// Record a short schedule with TASKMANAGER_TRACE_ENABLE in virtual time and dump the trace to a file.
+// The dump must contain the ids and names of all tasks and the events in the order of time,
+// the cost of update() (delayMicroseconds() in virtual time) must be recorded as the duration,
+// and tasks with the same name (or without name) must be recorded with different ids.
+// Convert the dump with taskmanager_trace2json and open it in chrome://tracing or https://ui.perfetto.dev.
+//
+//   usage: taskmanager_trace_record [trace.bin]
+
+#define TASKMANAGER_TRACE_ENABLE
+#define TASKMANAGER_TRACE_SIZE 256
+
+#include <Arduino.h>
+#include <TaskManager.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+    class Buffer : public Print {
+    public:
+        std::string data;
+        virtual size_t write(const uint8_t c) override {
+            data.push_back((char)c);
+            return 1;
+        }
+    };
+
+    class Sensor : public Task::Base {
+    public:
+        Sensor(const String& name) : Base(name) {}
+        virtual void enter() override {
+            delayMicroseconds(200);
+        }
+        virtual void update() override {
+            delayMicroseconds(300);
+        }
+        virtual void exit() override {
+            delayMicroseconds(100);
+        }
+    };
+
+    class Child : public Task::Base {
+    public:
+        Child(const String& name) : Base(name) {}
+        virtual void update() override {
+            delayMicroseconds(20);
+        }
+    };
+
+    uint32_t read32(const std::string& s, const size_t i) {
+        return (uint32_t)(uint8_t)s[i] | ((uint32_t)(uint8_t)s[i + 1] << 8) | ((uint32_t)(uint8_t)s[i + 2] << 16) |
+               ((uint32_t)(uint8_t)s[i + 3] << 24);
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* path = (argc > 1) ? argv[1] : "trace.bin";
+
+    arduino_shim::useVirtualClock();
+    Tasks.add<Sensor>("sensor")->startFpsForSec(100., 0.5);
+    Tasks.add("display", [] { delayMicroseconds(2000); })->startFps(30.);
+    Tasks.add("parent", [] { delayMicroseconds(50); })
+        ->sync<Child>("child", [](Task::Ref<Child>) {})
+        ->sync<Child>([](Task::Ref<Child>) {})  // unnamed
+        ->startFps(10.);
+    // same name as the first one
+    auto sensor = Tasks.getTaskByName("sensor");
+    auto twin = Tasks.add<Sensor>("sensor");
+    twin->startFpsForSec(100., 0.5);
+
+    // one second in virtual time: about 50 * 2 + 30 + 10 * 3 updates, 2 enter / exit and the sleeps in between
+    Tasks.clearTrace();
+    while (arduino_shim::elapsed_usec64() < 1000000)
+        Tasks.updateAndSleep([](const uint32_t us) { arduino_shim::advanceUsec(us); }, 100000);
+
+    Buffer buf;
+    const size_t bytes = Tasks.dumpTrace(buf);
+
+    bool ok = (bytes == buf.data.size()) && (bytes >= 20) && (memcmp(buf.data.data(), "TMTR", 4) == 0);
+    const uint32_t names = ok ? read32(buf.data, 8) : 0;
+    const uint32_t events = ok ? read32(buf.data, 12) : 0;
+    const uint32_t lost = ok ? read32(buf.data, 16) : 0;
+    uint32_t updates = 0, enters = 0, exits = 0, sleeps = 0, sensor_us = 0, twin_us = 0;
+    if (ok) {
+        size_t i = 20;
+        for (uint32_t n = 0; n < names; ++n) i += 5 + (uint8_t)buf.data[i + 4];
+        ok = (names == 6) && (lost == 0) && (i + events * 12 == bytes);
+        uint32_t prev_us = 0;
+        for (uint32_t n = 0; ok && (n < events); ++n, i += 12) {
+            const uint32_t begin_us = read32(buf.data, i);
+            const uint32_t info = read32(buf.data, i + 8);
+            if (begin_us < prev_us) ok = false;  // hooks run one by one on the main thread
+            prev_us = begin_us;
+            switch (info >> 24) {
+                case Task::TraceEvent::ENTER: ++enters; break;
+                case Task::TraceEvent::UPDATE: ++updates; break;
+                case Task::TraceEvent::EXIT: ++exits; break;
+                case Task::TraceEvent::SLEEP: ++sleeps; break;
+                default: break;
+            }
+            if ((info >> 24) == Task::TraceEvent::UPDATE) {
+                const uint32_t id = read32(buf.data, i + 4);
+                if (id == sensor->getTraceId()) sensor_us += info & 0x00FFFFFF;
+                if (id == twin->getTraceId()) twin_us += info & 0x00FFFFFF;
+            }
+        }
+    }
+    if (!ok || (sensor->getTraceId() == twin->getTraceId()) || (enters != 2) || (exits != 2) || (updates < 150) ||
+        (sleeps == 0) || (sensor_us != 50 * 300) || (twin_us != 50 * 300)) {
+        fprintf(stderr, "bytes %zu, names %u, events %u, lost %u, enter %u, exit %u, update %u, sleep %u\n", bytes,
+                names, events, lost, enters, exits, updates, sleeps);
+        ok = false;
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp || (fwrite(buf.data.data(), 1, buf.data.size(), fp) != buf.data.size())) {
+        fprintf(stderr, "cannot write %s\n", path);
+        ok = false;
+    }
+    if (fp) fclose(fp);
+
+    printf("{\"events\": %u, \"updates\": %u, \"sleeps\": %u, \"bytes\": %zu, \"file\": \"%s\", \"result\": \"%s\"}\n",
+           events, updates, sleeps, bytes, path, ok ? "ok" : "failed");
+    return ok ? 0 : 1;
+}
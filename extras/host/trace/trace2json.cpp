@@ -0,0 +1,179 @@
+// Convert a binary dump of Tasks.dumpTrace() to the Chrome trace event format (JSON).
+// Open the output in chrome://tracing or https://ui.perfetto.dev: every task instance has its own track
+// (tasks with the same name are suffixed by their ids), and the sleeps of Tasks.updateAndSleep() are shown
+// in the "sleep" track. Timestamps are relative to the first event, and wrap-around of micros() is unwrapped.
+// Tasks erased before the dump are shown as "task <id>", and with TASKMANAGER_NAME_HASH names are "#<hash>".
+//
+//   usage: taskmanager_trace2json [trace.bin|-] [trace.json|-]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const char* const HOOKS[] = {"enter", "update", "exit", "idle", "sleep"};
+    const uint8_t SLEEP = 4;
+
+    struct Reader {
+        std::vector<uint8_t> data;
+        size_t pos {0};
+        bool b_ok {true};
+
+        bool has(const size_t n) {
+            if (pos + n > data.size()) b_ok = false;
+            return b_ok;
+        }
+        uint8_t u8() {
+            return has(1) ? data[pos++] : 0;
+        }
+        uint16_t u16() {
+            if (!has(2)) return 0;
+            const uint16_t v = (uint16_t)(data[pos] | (data[pos + 1] << 8));
+            pos += 2;
+            return v;
+        }
+        uint32_t u32() {
+            if (!has(4)) return 0;
+            const uint32_t v = (uint32_t)data[pos] | ((uint32_t)data[pos + 1] << 8) |
+                               ((uint32_t)data[pos + 2] << 16) | ((uint32_t)data[pos + 3] << 24);
+            pos += 4;
+            return v;
+        }
+        std::string str(const size_t n) {
+            if (!has(n)) return std::string();
+            std::string s((const char*)&data[pos], n);
+            pos += n;
+            return s;
+        }
+    };
+
+    std::string escape(const std::string& s) {
+        std::string out;
+        for (const char c : s) {
+            if ((c == '"') || (c == '\\')) {
+                out += '\\';
+                out += c;
+            } else if ((unsigned char)c < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)(unsigned char)c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    // label of the track of a task
+    std::string label(const std::map<uint32_t, std::string>& names, const std::map<std::string, int>& counts,
+                      const uint32_t id) {
+        char buf[24];
+        auto it = names.find(id);
+        if ((it == names.end()) || it->second.empty()) {
+            snprintf(buf, sizeof(buf), "task %u", id);
+            return buf;
+        }
+        if (counts.at(it->second) == 1) return it->second;
+        snprintf(buf, sizeof(buf), " #%u", id);
+        return it->second + buf;
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* in_path = (argc > 1) ? argv[1] : "-";
+    const char* out_path = (argc > 2) ? argv[2] : "-";
+
+    FILE* in = (strcmp(in_path, "-") == 0) ? stdin : fopen(in_path, "rb");
+    if (!in) {
+        fprintf(stderr, "cannot open %s\n", in_path);
+        return 1;
+    }
+    Reader r;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) r.data.insert(r.data.end(), buf, buf + n);
+    if (in != stdin) fclose(in);
+
+    if (r.str(4) != "TMTR") {
+        fprintf(stderr, "%s is not a dump of Tasks.dumpTrace()\n", in_path);
+        return 1;
+    }
+    const uint16_t version = r.u16();
+    r.u16();  // reserved
+    if (version != 1) {
+        fprintf(stderr, "unsupported version %u\n", (unsigned)version);
+        return 1;
+    }
+    const uint32_t num_names = r.u32();
+    const uint32_t num_events = r.u32();
+    const uint32_t lost = r.u32();
+
+    std::map<uint32_t, std::string> names;
+    std::map<std::string, int> counts;
+    for (uint32_t i = 0; i < num_names; ++i) {
+        const uint32_t id = r.u32();
+        const std::string name = r.str(r.u8());
+        if (names.emplace(id, name).second) ++counts[name];
+    }
+
+    // one track (tid) per task instance in the order of appearance, the sleeps are in tid 0
+    std::map<uint32_t, uint32_t> tids;
+    std::vector<std::string> events;
+    int64_t ts = 0;
+    uint32_t prev_us = 0;
+    for (uint32_t i = 0; (i < num_events) && r.b_ok; ++i) {
+        const uint32_t begin_us = r.u32();
+        const uint32_t id = r.u32();
+        const uint32_t info = r.u32();
+        if (!r.b_ok) break;
+        if (i > 0) ts += (int32_t)(begin_us - prev_us);  // micros() wraps around every 71 minutes
+        prev_us = begin_us;
+
+        const uint8_t type = (uint8_t)(info >> 24);
+        const uint32_t dur = info & 0x00FFFFFF;
+        const char* hook = (type <= SLEEP) ? HOOKS[type] : "unknown";
+        uint32_t tid = 0;
+        std::string name = hook;
+        if (type != SLEEP) {
+            tid = tids.emplace(id, (uint32_t)tids.size() + 1).first->second;
+            name = label(names, counts, id);
+        }
+
+        char head[160];
+        snprintf(head, sizeof(head), "{\"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %lld, \"dur\": %u, \"cat\": \"%s\", ",
+                 tid, (long long)ts, dur, hook);
+        events.push_back(std::string(head) + "\"name\": \"" + escape(name) + "\"}");
+    }
+    if (!r.b_ok) {
+        fprintf(stderr, "%s is truncated\n", in_path);
+        return 1;
+    }
+    FILE* out = (strcmp(out_path, "-") == 0) ? stdout : fopen(out_path, "wb");
+    if (!out) {
+        fprintf(stderr, "cannot open %s\n", out_path);
+        return 1;
+    }
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"lost_events\": %u}, \"traceEvents\": [\n", lost);
+    fprintf(out, "{\"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"name\": \"thread_name\", \"args\": {\"name\": \"sleep\"}}");
+    for (const auto& t : tids) {
+        const std::string name = label(names, counts, t.first);
+        fprintf(out,
+                ",\n{\"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"name\": \"thread_name\", \"args\": {\"name\": \"%s\"}}",
+                t.second, escape(name).c_str());
+        fprintf(out,
+                ",\n{\"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"name\": \"thread_sort_index\", \"args\": "
+                "{\"sort_index\": %u}}",
+                t.second, t.second);
+    }
+    for (const auto& e : events) fprintf(out, ",\n%s", e.c_str());
+    fprintf(out, "\n]}\n");
+    if (out != stdout) fclose(out);
+
+    fprintf(stderr, "%u events, %zu tasks, %u lost\n", num_events, tids.size(), lost);
+    return 0;
+}